@@ -0,0 +1,169 @@
+/**
+ * @file bench_lexer.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Throughput benchmark of the scanner, built by make bench-lexer
+ *
+ * Synthetic programs of several kinds and sizes are generated in memory and scanned by get_me_token
+ * until EOF. Allocations are counted by wrapping malloc, realloc and calloc at link time.
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_MAX_SIZE (100 * 1024 * 1024) //Biggest generated program by default
+#define BENCH_MIN_TIME 0.2 //Small programs are scanned repeatedly for at least this many seconds
+#define BENCH_NAMES 4096 //Number of distinct identifiers in the generated programs
+
+static size_t allocations = 0; //Number of allocations since the last reset
+
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_calloc(size_t count, size_t size);
+
+void* __wrap_malloc(size_t size){
+    allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size){
+    allocations++;
+    return __real_realloc(ptr, size);
+}
+
+void* __wrap_calloc(size_t count, size_t size){
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+/// Kinds of generated programs
+typedef enum bench_kind {
+    BENCH_IDENTIFIERS,
+    BENCH_LITERALS,
+    BENCH_COMMENTS,
+    BENCH_MULTILINE,
+    BENCH_KIND_COUNT
+} bench_kind_t;
+
+static const char* const kind_names[BENCH_KIND_COUNT] = {"identifiers", "literals", "comments", "multiline"};
+
+static const size_t sizes[] = {1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 100 * 1024 * 1024};
+
+//Writes one statement of the program of given kind into line, returns its length
+static int generate_statement(bench_kind_t kind, unsigned long i, char* line, size_t size){
+    switch(kind){
+        case BENCH_IDENTIFIERS:
+            return snprintf(line, size, "var counter_%lu = someValue%lu + otherValue_%lu * total%lu\n",
+                            i % BENCH_NAMES, (i + 1) % BENCH_NAMES, (i + 2) % BENCH_NAMES, (i + 3) % BENCH_NAMES);
+        case BENCH_LITERALS:
+            return snprintf(line, size, "let x = %lu + %lu.%03lu * 2.5e-3 - 1E+%lu + \"item%lu\"\n",
+                            i, i % 1000, i % 997, i % 300, i);
+        case BENCH_COMMENTS:
+            return snprintf(line, size, "// line comment number %lu with some text\n"
+                                        "x = 1 /* block comment %lu /* nested %lu */ still in the comment */ + 2\n", i, i, i);
+        case BENCH_MULTILINE:
+            return snprintf(line, size, "let s = \"\"\"\n"
+                                        "    first line of text %lu\n"
+                                        "      indented line with # sign\n"
+                                        "    last line\n"
+                                        "    \"\"\"\n", i);
+        default:
+            return 0;
+    }
+}
+
+//Generates program of given kind with at least size bytes
+static char* generate_program(bench_kind_t kind, size_t size, size_t* length){
+    char line[256];
+    char* data = (char*) allocate_memory(size + sizeof(line));
+    *length = 0;
+    for(unsigned long i = 0; *length < size; i++){
+        int line_length = generate_statement(kind, i, line, sizeof(line));
+        memcpy(data + *length, line, line_length);
+        *length += line_length;
+    }
+    return data;
+}
+
+static double now(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Scans the program until EOF, returns the number of tokens
+static size_t scan_program(const char* program, size_t length){
+    char* data = (char*) allocate_memory(length);
+    memcpy(data, program, length);
+    source_init_buffer(data, length);
+
+    size_t tokens = 0;
+    token_t* token;
+    while((token = get_me_token())->type != TOKEN_EOF){
+        tokens++;
+        //Nothing older than the current token is needed, just like in the parser
+        token_arena_release(token);
+    }
+    source_dispose();
+    return tokens;
+}
+
+static void bench(bench_kind_t kind, size_t size){
+    size_t length;
+    char* program = generate_program(kind, size, &length);
+
+    size_t bytes = 0, tokens = 0, allocated = 0;
+    double elapsed = 0;
+    do {
+        allocations = 0;
+        double start = now();
+        tokens += scan_program(program, length);
+        elapsed += now() - start;
+        //The copy of the program handed over to the scanner is not counted
+        allocated += allocations - 1;
+        bytes += length;
+    } while(elapsed < BENCH_MIN_TIME);
+
+    printf("%-12s %10zu B %10.1f MB/s %10.2f Mtok/s %10.4f alloc/tok\n", kind_names[kind], length,
+           bytes / elapsed / 1e6, tokens / elapsed / 1e6, tokens ? (double) allocated / tokens : 0.0);
+    free(program);
+}
+
+int main(int argc, char** argv){
+    size_t max_size = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_DEFAULT_MAX_SIZE;
+
+    for(int kind = 0; kind < BENCH_KIND_COUNT; kind++){
+        for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= max_size; i++){
+            bench(kind, sizes[i]);
+        }
+    }
+
+    token_arena_dispose();
+    intern_dispose();
+    return 0;
+}
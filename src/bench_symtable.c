@@ -0,0 +1,135 @@
+/**
+ * @file bench_symtable.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Benchmark of the symbol table backend, built by make bench-symtable once for each backend
+ *
+ * Scopes of several sizes are filled with interned names and searched for names which are in them and which
+ * are not. Allocations are counted by wrapping malloc, realloc and calloc at link time.
+ *
+ * @author Adam Valík <xvalik05>
+ * @author Marek Effenberger <xeffen00>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MIN_TIME 0.2 // every scope size is measured repeatedly for at least this many seconds
+#define BENCH_LOOKUP_ROUNDS 8 // every name of the scope is searched this many times per round
+
+static size_t allocations = 0; // number of allocations since the last reset
+
+void *__real_malloc(size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_calloc(size_t count, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    allocations++;
+    return __real_realloc(ptr, size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+static const int sizes[] = {4, 16, 64, 256, 4096, 65536};
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Names of the symbols in the scope and the same number of names which are not in it
+static char **make_names(int count, const char *prefix) {
+    char **names = (char **)allocate_memory(count * sizeof(char *));
+    char name[32];
+    for (int i = 0; i < count; i++) {
+        snprintf(name, sizeof(name), "%s_%d", prefix, i);
+        names[i] = intern_str(name);
+    }
+    return names;
+}
+
+static void bench(int count) {
+    char **present = make_names(count, "var");
+    char **missing = make_names(count, "other");
+
+    double insert_time = 0, lookup_time = 0;
+    size_t inserts = 0, lookups = 0, allocated = 0;
+    do {
+        symtable_t *table = NULL;
+
+        allocations = 0;
+        double start = now();
+        for (int i = 0; i < count; i++) {
+            symtable_insert(&table, present[i], set_data_var(true, INT, VAR));
+        }
+        insert_time += now() - start;
+        allocated += allocations;
+        inserts += count;
+
+        start = now();
+        for (int round = 0; round < BENCH_LOOKUP_ROUNDS; round++) {
+            for (int i = 0; i < count; i++) {
+                if (symtable_search(table, present[i]) == NULL || symtable_search(table, missing[i]) != NULL) {
+                    error_exit(ERROR_INTERNAL, "BENCH", "Symbol table returned a wrong result.");
+                }
+            }
+        }
+        lookup_time += now() - start;
+        lookups += 2 * BENCH_LOOKUP_ROUNDS * (size_t)count;
+
+        // Every other symbol is deleted, the rest has to be found still
+        for (int i = 0; i < count; i += 2) {
+            symtable_delete(&table, present[i]);
+        }
+        for (int i = 0; i < count; i++) {
+            if ((symtable_search(table, present[i]) == NULL) != (i % 2 == 0)) {
+                error_exit(ERROR_INTERNAL, "BENCH", "Symbol table returned a wrong result after deletion.");
+            }
+        }
+        symtable_dispose(&table);
+    } while (insert_time + lookup_time < BENCH_MIN_TIME);
+
+    printf("%-5s %6d symbols %10.1f ns/insert %10.1f ns/lookup %8.2f alloc/symbol\n", SYMTABLE_BACKEND, count,
+           insert_time / inserts * 1e9, lookup_time / lookups * 1e9, (double)allocated / inserts);
+    free(present);
+    free(missing);
+}
+
+int main() {
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench(sizes[i]);
+    }
+    intern_dispose();
+    return 0;
+}
@@ -12,14 +12,20 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 #include <string.h>
 #include <stdbool.h>
@@ -39,8 +45,7 @@ callee_list_t* init_callee_list() {
 callee_t* init_callee(const char* name) {
     callee_t* callee = (callee_t*)allocate_memory(sizeof(callee_t));
 
-    callee->name = (char*)allocate_memory(strlen(name) + 1);
-    callee->name = strcpy(callee->name, name);
+    callee->name = (char*)name; // interned, shared with the FUNC_CALL instruction
 
     callee->return_type = UNKNOWN;
     arg_counter = 0;
@@ -75,7 +80,6 @@ void insert_name_into_callee(callee_t* callee, char* name) {
     arg_counter++;
     callee->arg_count = arg_counter;
 
-    callee->args_names[callee->arg_count] = (char*)allocate_memory(strlen(name) + 1);
     callee->args_names[callee->arg_count] = name;
 }
 
@@ -92,43 +96,34 @@ void insert_bool_into_callee(callee_t* callee, bool is_initialized) {
 }
 
 
+void callee_dispose(callee_t *callee) {
+    // Free callee structure members, the names are interned and owned by the pool
+    if (callee->args_names) {
+        free(callee->args_names);
+        callee->args_names = NULL;
+    }
+
+    if (callee->args_initialized) {
+        free(callee->args_initialized);
+        callee->args_initialized = NULL;
+    }
+
+    if (callee->args_types) {
+        free(callee->args_types);
+        callee->args_types = NULL;
+    }
+
+    // Free callee structure itself
+    free(callee);
+}
+
 void callee_list_dispose(callee_list_t *first) {
     callee_list_t *current = first;
     callee_list_t *next;
 
     while (current != NULL) {
         if (current->callee) {
-            callee_t *callee = current->callee;
-
-            // Free callee structure members
-            if (callee->name) {
-                free(callee->name);
-                callee->name = NULL;
-            }
-
-            if (callee->args_names) {
-                for (int i = 0; i < callee->arg_count; ++i) {
-                    if (callee->args_names[i]) {
-                        free(callee->args_names[i]);
-                        callee->args_names[i] = NULL;
-                    }
-                }
-                free(callee->args_names);
-                callee->args_names = NULL;
-            }
-
-            if (callee->args_initialized) {
-                free(callee->args_initialized);
-                callee->args_initialized = NULL;
-            }
-
-            if (callee->args_types) {
-                free(callee->args_types);
-                callee->args_types = NULL;
-            }
-
-            // Free callee structure itself
-            free(callee);
+            callee_dispose(current->callee);
             current->callee = NULL;
         }
 
@@ -42,7 +42,7 @@ callee_list_t* init_callee_list();
 /**
  * @brief Allocates memory for a new callee and initializes it
  * 
- * @param name Name of the callee
+ * @param name Interned name of the callee
  * @return callee_t* Pointer to the new callee
  */
 callee_t* init_callee(const char* name);
@@ -51,7 +51,7 @@ callee_t* init_callee(const char* name);
  * @brief Inserts a new callee into the callee list
  * 
  * @param list Pointer to the callee list
- * @param name Name of the callee
+ * @param name Interned name of the callee
  */
 void insert_callee_into_list(callee_list_t* list, const char* name);
 
@@ -59,7 +59,7 @@ void insert_callee_into_list(callee_list_t* list, const char* name);
  * @brief Inserts a argument's name into callee 
  * 
  * @param callee Pointer to the callee
- * @param id Name of the argument
+ * @param id Interned name of the argument
  */
 void insert_name_into_callee(callee_t* callee, char* id);
 
@@ -79,6 +79,13 @@ void insert_type_into_callee(callee_t* callee, data_type type);
  */
 void insert_bool_into_callee(callee_t* callee, bool is_initialized);
 
+/**
+ * @brief Disposes the callee and its arguments
+ * 
+ * @param callee Pointer to the callee
+ */
+void callee_dispose(callee_t *callee);
+
 /**
  * @brief Disposes the whole callee list
  * 
@@ -11,130 +11,181 @@
 
 
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <string.h>
 
 int add_arg_cnt = 0; // for codegen_add_arg for unique naming of arguments
 int write_renamer = 0; // for codegen_write for unique naming of arguments
+bool codegen_stream_enabled = false;
+bool codegen_pipe_enabled = false;
 extern FILE *file;
 
 
+#define INST_BUFFER_INIT 1024 // initial number of instructions in the buffer
+
+static char null_name[] = "null"; // name of the instructions without name, shared by all of them
+
 void inst_list_init(instruction_list *list) {
-    instruction *inst = inst_init(MAIN, 'G', NULL, 0, 0, 0.0, NULL);
-    list->active = list->first = list->last = inst;
+    list->capacity = INST_BUFFER_INIT;
+    list->insts = (instruction*) allocate_memory(list->capacity * sizeof(instruction));
+    list->insts[0] = inst_init(MAIN, 'G', NULL, 0, 0, 0.0, NULL);
+    list->insts[0].prev = list->insts[0].next = INST_NONE;
+    list->count = 1;
+    list->active = list->first = list->last = 0;
+    list->emitted = INST_NONE;
+    list->names = NULL;
+    list->names_count = 0;
+    list->names_capacity = 0;
 }
 
 
-instruction* inst_init(inst_type type,
+instruction inst_init(inst_type type,
                         char frame,
                         char *name,
                         int cnt,
-                        int int_value,
+                        long long int_value,
                         double float_value,
                         char *string_value
 ) {
-	instruction* new_inst = (instruction*) allocate_memory(sizeof(instruction));
-
-    new_inst->relevant_node = active;
-    new_inst->inst_type = type;
-    new_inst->frame = frame;
-    if (name == NULL) {
-        new_inst->name = (char*) allocate_memory(sizeof(char) * 6);
-        strcpy(new_inst->name, "null");
-    }
-    else {
-        new_inst->name = name;
+    instruction new_inst;
+
+    new_inst.prev = new_inst.next = INST_NONE;
+    new_inst.inst_type = type;
+    new_inst.frame = frame;
+    new_inst.name = name != NULL ? name : null_name;
+    new_inst.cnt = cnt;
+    new_inst.int_value = int_value;
+    switch (type) {
+        case FUNC_DEF:
+            new_inst.relevant_node = active;
+            break;
+        case PUSHS_STRING_CONST:
+            new_inst.string_value = string_value;
+            break;
+        default:
+            new_inst.float_value = float_value;
+            break;
     }
-    new_inst->cnt = cnt;
-    new_inst->int_value = int_value;
-    new_inst->float_value = float_value;
-    new_inst->string_value = string_value;
     return new_inst;
  }
 
+// copies the instruction into a new slot at the end of the buffer, the links are set by the caller
+static int inst_list_append_slot(instruction_list *list, instruction *new_inst) {
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        list->insts = (instruction*) reallocate_memory(list->insts, list->capacity * sizeof(instruction));
+    }
+    list->insts[list->count] = *new_inst;
+    return list->count++;
+}
+
 
 void inst_list_insert_last(instruction_list *list, instruction *new_inst) {
-    new_inst->next = NULL;
-    new_inst->prev = list->last;
+    int index = inst_list_append_slot(list, new_inst);
+    list->insts[index].next = INST_NONE;
+    list->insts[index].prev = list->last;
 
-    // re-setting already existing pointers
-    list->last->next = new_inst;
-    list->last = new_inst;
+    // re-setting already existing links
+    list->insts[list->last].next = index;
+    list->last = index;
 
     // active is now the new instruction
-    list->active = new_inst;
+    list->active = index;
 }
 
 void inst_list_insert_before(instruction_list *list, instruction *new_inst) {
-    new_inst->next = list->active;
-    new_inst->prev = list->active->prev;
+    int index = inst_list_append_slot(list, new_inst);
+    instruction *active_inst = &list->insts[list->active];
+    list->insts[index].next = list->active;
+    list->insts[index].prev = active_inst->prev;
 
-    // re-setting already existing pointers
-    list->active->prev->next = new_inst;
-    list->active->prev = new_inst;
+    // re-setting already existing links
+    list->insts[active_inst->prev].next = index;
+    active_inst->prev = index;
 
     // active is now the new instruction
-    list->active = new_inst;
+    list->active = index;
 }
 
 
-void inst_list_delete_after(instruction_list *list) {
-    instruction *inst = list->active->next;
-    // re-pointing the pointers across the deleted node
-    if (inst == list->last) {
-        list->last = list->active;
+void inst_list_own_name(instruction_list *list, char *name) {
+    if (list->names_count == list->names_capacity) {
+        list->names_capacity = list->names_capacity == 0 ? 64 : 2 * list->names_capacity;
+        list->names = (char**) reallocate_memory(list->names, list->names_capacity * sizeof(char*));
     }
-    else {
-        inst->next->prev = list->active;
-    }
-    list->active->next = inst->next;
-    free(inst);
+    list->names[list->names_count++] = name;
 }
 
-void inst_list_dispose(instruction_list *list) {
-	instruction* inst = list->first;
-	while (list->first != NULL) {
-		list->first = list->first->next;
-		free(inst);
-		inst = list->first;
-	}
-
-	list->active = NULL;
-	list->first = NULL;
-	list->last = NULL;
-}
-
-// search outermost while loop
-void inst_list_search_while(instruction_list *list, char *while_name) {
-    // move list->active based on the name of the node
-    while (strcmp(list->active->name, while_name) != 0 || list->active->inst_type != WHILE_START) {
-        list->active = list->active->prev;
+// frees the owned names, the instructions using them are not generated anymore
+static void free_names(char **names, int count) {
+    for (int i = 0; i < count; i++) {
+        free(names[i]);
     }
-    // list->active is now outermost while loop, you can insert before it
 }
 
-// search call of void function
-void inst_list_search_void_func_call(instruction_list *list, char *func_name) {
-    // move list->active based on the name of the node found 
-    list->active = list->last;
-    while (strcmp(list->active->name, func_name) != 0 || list->active->inst_type != FUNC_CALL || list->active->next == NULL || list->active->next->inst_type != FUNC_CALL_RETVAL) {
-        list->active = list->active->prev;
+// frees the copies of the string constants, the instructions using them are not generated anymore
+static void free_strings(instruction *insts, int count) {
+    for (int i = 0; i < count; i++) {
+        if (insts[i].inst_type == PUSHS_STRING_CONST) {
+            free(insts[i].string_value);
+            insts[i].string_value = NULL;
+        }
     }
-    // list->active is now void_function call, you can delete the instruction after it
 }
 
-// goes through the whole list and prints the instructions based on their type
-void codegen_generate_code_please(instruction_list *list) {
-    instruction *inst = list->first;
-    while (inst != NULL) {
+static void inst_list_free_names(instruction_list *list) {
+    free_names(list->names, list->names_count);
+    list->names_count = 0;
+}
+
+static void inst_list_free_strings(instruction_list *list) {
+    free_strings(list->insts, list->count);
+}
+
+void inst_list_dispose(instruction_list *list) {
+    inst_list_free_strings(list);
+    free(list->insts);
+    list->insts = NULL;
+    list->count = 0;
+    list->capacity = 0;
+
+    list->active = INST_NONE;
+    list->first = INST_NONE;
+    list->last = INST_NONE;
+    list->emitted = INST_NONE;
+
+    inst_list_free_names(list);
+    free(list->names);
+    list->names = NULL;
+    list->names_capacity = 0;
+}
+
+void inst_list_activate(instruction_list *list, int index) {
+    list->active = index;
+}
+
+// prints the instructions from index to the end of the list based on their type
+static void codegen_generate_from(instruction *insts, int index) {
+    while (index != INST_NONE) {
+        // the next instruction is the following slot of the buffer unless something was inserted before it
+        instruction *inst = &insts[index];
         switch (inst->inst_type) {
             case MAIN:
                 codegen_main(inst);
@@ -149,7 +200,7 @@ void codegen_generate_code_please(instruction_list *list) {
                 codegen_var_assign_nil(inst);
                 break;
             case IMPLICIT_NIL: // implicit nil assignment
-                printf("MOVE %cF@%s nil@nil\n", inst->frame, inst->name);
+                EMIT_LITERAL("MOVE "); emit_frame(inst->frame); emit_str(inst->name); EMIT_LITERAL(" nil@nil\n");
                 break;
             case FUNC_DEF:
                 codegen_func_def(inst);
@@ -170,16 +221,16 @@ void codegen_generate_code_please(instruction_list *list) {
                 codegen_add_arg(inst);
                 break;
             case FUNC_CALL:
-                printf("CALL %s\n", inst->name);
+                EMIT_LITERAL("CALL "); emit_str(inst->name); emit_char('\n');
                 break;
             case FUNC_CALL_RETVAL:
-                printf("PUSHS TF@$retval$\n");
+                EMIT_LITERAL("PUSHS TF@$retval$\n");
                 break;
             case IF_LABEL:
-                printf("LABEL if_%d\n", inst->cnt);
+                EMIT_LITERAL("LABEL if_"); emit_int(inst->cnt); emit_char('\n');
                 break;
             case IF_DEFVAR:
-                printf("DEFVAR %cF@$cond_%d$\n", inst->frame, inst->cnt);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
                 break;
             case IF_LET:
                 codegen_if_let(inst);
@@ -194,10 +245,10 @@ void codegen_generate_code_please(instruction_list *list) {
                 codegen_ifelse_end(inst);
                 break;
             case WHILE_COND_DEF:
-                printf("DEFVAR %cF@$cond_%s$\n", inst->frame, inst->name);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_str(inst->name); EMIT_LITERAL("$\n");
                 break;
             case WHILE_START:
-                printf("LABEL %s\n", inst->name);
+                EMIT_LITERAL("LABEL "); emit_str(inst->name); emit_char('\n');
                 break;
             case WHILE_DO:
                 codegen_while_do(inst);
@@ -239,440 +290,574 @@ void codegen_generate_code_please(instruction_list *list) {
                 codegen_concat(inst);
                 break;
             case CONCAT_DEFVAR:
-                printf("DEFVAR %cF@$$s%d$$\n", inst->frame, inst->cnt);
-                printf("DEFVAR %cF@$$s%d$$\n", inst->frame, inst->cnt + 1);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
                 break;
             case INT2FLOATS:
-                printf("INT2FLOATS\n");
+                EMIT_LITERAL("INT2FLOATS\n");
                 break;
             case INT2FLOATS_2:
                 codegen_int2floats(inst);
                 break;
             case INT2FLOATS_2_DEFVAR:
-                printf("DEFVAR %cF@$$tmp%d$$\n", inst->frame, inst->cnt);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$tmp"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
                 break;
             case DIV_ZERO_DEFVAR:
-                printf("DEFVAR %cF@div_zero_%d\n", inst->frame, inst->cnt);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("div_zero_"); emit_int(inst->cnt); emit_char('\n');
                 break;
             case DIV_BY_ZERO:
                 codegen_div_zero(inst);
                 break;
             case DIVS:
-                printf("DIVS\n");
+                EMIT_LITERAL("DIVS\n");
                 break;
             case IDIV_ZERO_DEFVAR:
-                printf("DEFVAR %cF@idiv_zero_%d\n", inst->frame, inst->cnt);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("idiv_zero_"); emit_int(inst->cnt); emit_char('\n');
                 break;
             case IDIV_BY_ZERO:
                 codegen_idiv_zero(inst);
                 break;
             case IDIVS:
-                printf("IDIVS\n");
+                EMIT_LITERAL("IDIVS\n");
                 break;
             case PUSHS_INT_CONST:
-                printf("PUSHS int@%d\n", inst->int_value);
+                EMIT_LITERAL("PUSHS int@"); emit_int(inst->int_value); emit_char('\n');
                 break;
             case PUSHS_FLOAT_CONST:
-                printf("PUSHS float@%a\n", inst->float_value);
+                EMIT_LITERAL("PUSHS float@"); emit_float(inst->float_value); emit_char('\n');
                 break;
             case PUSHS_STRING_CONST:
-                printf("PUSHS string@%s\n", inst->string_value);
+                EMIT_LITERAL("PUSHS string@");
+                codegen_string_const(inst->string_value, inst->int_value);
+                emit_char('\n');
                 break;
             case PUSHS_NIL:
-                printf("PUSHS nil@nil\n");
+                EMIT_LITERAL("PUSHS nil@nil\n");
                 break;
             case PUSHS:
-                printf("PUSHS %cF@%s\n", inst->frame, inst->name);
+                EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); emit_str(inst->name); emit_char('\n');
                 break;
             case EXCLAMATION_RULE:
                 codegen_exclamation_rule(inst);
                 break;
             case EXCLAMATION_RULE_DEFVAR:
-                printf("DEFVAR %cF@$$excl%d\n", inst->frame, inst->cnt);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$excl"); emit_int(inst->cnt); emit_char('\n');
                 break;
             case ADDS:
-                printf("ADDS\n");
+                EMIT_LITERAL("ADDS\n");
                 break;
             case MULS:
-                printf("MULS\n");
+                EMIT_LITERAL("MULS\n");
                 break;
             case SUBS:
-                printf("SUBS\n");
+                EMIT_LITERAL("SUBS\n");
                 break;
             case LTS:
-                printf("LTS\n");
+                EMIT_LITERAL("LTS\n");
                 break;
             case EQS:
-                printf("EQS\n");
+                EMIT_LITERAL("EQS\n");
                 break;
             case ORS:
-                printf("ORS\n");
+                EMIT_LITERAL("ORS\n");
                 break;
             case GTS:
-                printf("GTS\n");
+                EMIT_LITERAL("GTS\n");
                 break;
             case NOTS:
-                printf("NOTS\n");
+                EMIT_LITERAL("NOTS\n");
                 break;
             case LEQ_RULE:
                 codegen_leq_rule(inst);
                 break;
             case LEQ_RULE_DEFVAR:
-                printf("DEFVAR %cF@$$leq%d$$\n", inst->frame, inst->cnt);
-                printf("DEFVAR %cF@$$leq%d$$\n", inst->frame, inst->cnt + 1);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$leq"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$leq"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
                 break;
             case GEQ_RULE:
                 codegen_geq_rule(inst);
                 break;
             case GEQ_RULE_DEFVAR:
-                printf("DEFVAR %cF@$$geq%d$$\n", inst->frame, inst->cnt);
-                printf("DEFVAR %cF@$$geq%d$$\n", inst->frame, inst->cnt + 1);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$geq"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$geq"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
                 break;
             case QMS_RULE:
                 codegen_qms_rule(inst);
                 break;
             case QMS_RULE_DEFVAR:
-                printf("DEFVAR %cF@$$rule_qms%d\n", inst->frame, inst->cnt);
-                printf("DEFVAR %cF@$$rule_qms%d\n", inst->frame, inst->cnt + 1);
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt); emit_char('\n');
+                EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt + 1); emit_char('\n');
                 break;
             default:
                 break;
         }
-        inst = inst->next;
+        index = inst->next;
+    }
+}
+
+// Instructions handed over to the emitter thread together with everything they own
+typedef struct codegen_batch {
+    instruction *insts;
+    int first; // index of the first instruction to be generated
+    int count; // number of used slots of the buffer
+    char **names;
+    int names_count;
+} codegen_batch_t;
+
+static struct codegen_pipe {
+    _Alignas(64) _Atomic size_t head; // number of pushed batches, written by the parser thread
+    _Alignas(64) _Atomic size_t tail; // number of generated batches, written by the emitter thread
+    _Alignas(64) _Atomic bool closed; // the parser thread pushed its last batch
+    bool running; // owned by the parser thread
+    pthread_t thread;
+    codegen_batch_t slots[CODEGEN_PIPE_CAPACITY];
+} codegen_pipe;
+
+static void *codegen_pipe_emit(void *arg) {
+    (void)arg;
+    while (true) {
+        size_t tail = atomic_load_explicit(&codegen_pipe.tail, memory_order_relaxed);
+        if (atomic_load_explicit(&codegen_pipe.head, memory_order_acquire) == tail) {
+            // closed is set behind the last push, the batches pushed before it are seen by the next load of head
+            if (atomic_load_explicit(&codegen_pipe.closed, memory_order_acquire) &&
+                atomic_load_explicit(&codegen_pipe.head, memory_order_acquire) == tail) {
+                return NULL;
+            }
+            sched_yield();
+            continue;
+        }
+
+        codegen_batch_t *batch = &codegen_pipe.slots[tail & (CODEGEN_PIPE_CAPACITY - 1)];
+        codegen_generate_from(batch->insts, batch->first);
+        free_strings(batch->insts, batch->count);
+        free(batch->insts);
+        free_names(batch->names, batch->names_count);
+        free(batch->names);
+        atomic_store_explicit(&codegen_pipe.tail, tail + 1, memory_order_release);
+    }
+}
+
+void codegen_pipe_start() {
+    if (!codegen_stream_enabled || !codegen_pipe_enabled) {
+        return;
+    }
+
+    atomic_init(&codegen_pipe.head, 0);
+    atomic_init(&codegen_pipe.tail, 0);
+    atomic_init(&codegen_pipe.closed, false);
+    if (pthread_create(&codegen_pipe.thread, NULL, codegen_pipe_emit, NULL) != 0) {
+        error_exit(ERROR_INTERNAL, "CODEGEN", "Emitter thread cannot be created");
+    }
+    codegen_pipe.running = true;
+}
+
+void codegen_pipe_stop() {
+    if (!codegen_pipe.running) {
+        return;
+    }
+    atomic_store_explicit(&codegen_pipe.closed, true, memory_order_release);
+    pthread_join(codegen_pipe.thread, NULL);
+    codegen_pipe.running = false;
+}
+
+// the batch waits while the emitter thread is behind by the whole pipe, so the memory stays bounded
+static void codegen_pipe_push(codegen_batch_t *batch) {
+    size_t head = atomic_load_explicit(&codegen_pipe.head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&codegen_pipe.tail, memory_order_acquire) == CODEGEN_PIPE_CAPACITY) {
+        sched_yield();
+    }
+    codegen_pipe.slots[head & (CODEGEN_PIPE_CAPACITY - 1)] = *batch;
+    atomic_store_explicit(&codegen_pipe.head, head + 1, memory_order_release);
+}
+
+// goes through the instructions not generated yet and prints them, then writes the output
+void codegen_generate_code_please(instruction_list *list) {
+    // the output of the emitter thread comes first
+    codegen_pipe_stop();
+    codegen_generate_from(list->insts, list->emitted != INST_NONE ? list->insts[list->emitted].next : list->first);
+    emit_flush();
+}
+
+// in streaming mode the generated instructions are freed right away, the output is written when the buffer is full
+void codegen_generate_pending(instruction_list *list) {
+    int first = list->emitted != INST_NONE ? list->insts[list->emitted].next : list->first;
+    instruction kept = list->insts[list->last];
+
+    if (codegen_pipe.running) {
+        // the emitter thread takes the whole buffer, the list continues in a new one
+        codegen_batch_t batch = {list->insts, first, list->count, list->names, list->names_count};
+        codegen_pipe_push(&batch);
+        list->capacity = INST_BUFFER_INIT;
+        list->insts = (instruction*) allocate_memory(list->capacity * sizeof(instruction));
+        list->names = NULL;
+        list->names_count = 0;
+        list->names_capacity = 0;
+    }
+    else {
+        codegen_generate_from(list->insts, first);
+        inst_list_free_strings(list);
+        inst_list_free_names(list);
+    }
+
+    // the buffer starts over with the last instruction only
+    // it is never generated again, so its name and string are not needed either
+    if (kept.inst_type == PUSHS_STRING_CONST) {
+        kept.string_value = NULL;
+    }
+    list->insts[0] = kept;
+    list->insts[0].prev = list->insts[0].next = INST_NONE;
+    list->count = 1;
+    list->active = list->first = list->last = list->emitted = 0;
+}
+
+
+void codegen_string_const(const char *str, int length) {
+    const char *end = str + length;
+    while (str < end) {
+        // Run of characters which need no escape sequence is printed at once
+        const char *run = simd_skip_string_constant(str, end);
+        emit_mem(str, run - str);
+        if (run == end) {
+            break;
+        }
+        unsigned char c = (unsigned char)*run;
+        char escape[4] = {'\\', '0' + c / 100, '0' + c / 10 % 10, '0' + c % 10};
+        emit_mem(escape, sizeof(escape));
+        str = run + 1;
     }
 }
 
 
 void codegen_var_def(instruction *inst) {
-    printf("DEFVAR %cF@%s\n", inst->frame, inst->name);
+    EMIT_LITERAL("DEFVAR "); emit_frame(inst->frame); emit_str(inst->name); emit_char('\n');
 }
 
 // assign value from the top of the stack to the variable
 void codegen_var_assign(instruction *inst) {
-    printf("POPS %cF@%s\n", inst->frame, inst->name);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); emit_str(inst->name); emit_char('\n');
 }
 
 // nil assignment
 void codegen_var_assign_nil(instruction *inst) {
-    printf("MOVE %cF@%s nil@nil\n", inst->frame, inst->name);
+    EMIT_LITERAL("MOVE "); emit_frame(inst->frame); emit_str(inst->name); EMIT_LITERAL(" nil@nil\n");
 }
 
 // function definition
 void codegen_func_def(instruction *inst) {
-    printf("JUMP !!skip_%s\n", inst->name);
-    printf("LABEL %s\n", inst->name);
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("JUMP !!skip_"); emit_str(inst->name); emit_char('\n');
+    EMIT_LITERAL("LABEL "); emit_str(inst->name); emit_char('\n');
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
     for (int i = 1; i <= inst->cnt; i++) {
-        // find the parameter in the symtable based on its param_order
-        AVL_tree* param = symtable_find_param(inst->relevant_node->symtable, i);
-        printf("DEFVAR LF@%s\n", param->key);
-        printf("MOVE LF@%s LF@$%d\n", param->key, i);
+        // parameters of the function are stored in order
+        forest_param *param = &inst->relevant_node->params[i - 1];
+        EMIT_LITERAL("DEFVAR LF@"); emit_str(param->id); emit_char('\n');
+        EMIT_LITERAL("MOVE LF@"); emit_str(param->id); EMIT_LITERAL(" LF@$"); emit_int(i); emit_char('\n');
     } 
 }
 
 // return value is on the top of the stack
 void codegen_func_def_return(instruction *inst) {
-    printf("POPS LF@$retval$\n");
-    printf("JUMP end_%s\n", inst->name);
+    EMIT_LITERAL("POPS LF@$retval$\n");
+    EMIT_LITERAL("JUMP end_"); emit_str(inst->name); emit_char('\n');
 }
 
 // void function without return value
 void codegen_func_def_return_void(instruction *inst) {
-    printf("JUMP end_%s\n", inst->name);
+    EMIT_LITERAL("JUMP end_"); emit_str(inst->name); emit_char('\n');
 }
 
 // end of function definition
 void codegen_func_def_end(instruction *inst) {
-    printf("LABEL end_%s\n", inst->name);
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_%s\n", inst->name);
+    EMIT_LITERAL("LABEL end_"); emit_str(inst->name); emit_char('\n');
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_"); emit_str(inst->name); emit_char('\n');
 }
 
 
 void codegen_func_call_start(instruction *inst) {
     add_arg_cnt = 0;
-    printf("CREATEFRAME\n");
+    EMIT_LITERAL("CREATEFRAME\n");
 }
 
 void codegen_add_arg(instruction *inst) {
-    printf("DEFVAR TF@$%d\n", ++add_arg_cnt);
-    printf("POPS TF@$%d\n", add_arg_cnt);
+    EMIT_LITERAL("DEFVAR TF@$"); emit_int(++add_arg_cnt); emit_char('\n');
+    EMIT_LITERAL("POPS TF@$"); emit_int(add_arg_cnt); emit_char('\n');
 }
 
 
 // if let - do the else statement if the variable is nil
 void codegen_if_let(instruction *inst) {
-    printf("TYPE %cF@$cond_%d$ %cF@%s\n", inst->frame, inst->cnt, inst->frame, inst->name);
-    printf("JUMPIFEQ else_%d %cF@$cond_%d$ string@nil\n", inst->cnt, inst->frame, inst->cnt); 
+    EMIT_LITERAL("TYPE "); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_int(inst->cnt); EMIT_LITERAL("$ "); emit_frame(inst->frame); emit_str(inst->name); emit_char('\n');
+    EMIT_LITERAL("JUMPIFEQ else_"); emit_int(inst->cnt); emit_char(' '); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_int(inst->cnt); EMIT_LITERAL("$ string@nil\n");
 }
 
 // if - do the else statement if the condition is false
 void codegen_if(instruction *inst) {
-    printf("POPS %cF@$cond_%d$\n", inst->frame, inst->cnt);
-    printf("JUMPIFEQ else_%d %cF@$cond_%d$ bool@false\n", inst->cnt, inst->frame, inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("JUMPIFEQ else_"); emit_int(inst->cnt); emit_char(' '); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_int(inst->cnt); EMIT_LITERAL("$ bool@false\n");
 }
 
 // else statement
 void codegen_else(instruction *inst) {
-    printf("JUMP end_if_%d\n", inst->cnt);
-    printf("LABEL else_%d\n", inst->cnt);
+    EMIT_LITERAL("JUMP end_if_"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("LABEL else_"); emit_int(inst->cnt); emit_char('\n');
 
 }
 
 void codegen_ifelse_end(instruction *inst) {
-    printf("LABEL end_if_%d\n", inst->cnt);
+    EMIT_LITERAL("LABEL end_if_"); emit_int(inst->cnt); emit_char('\n');
 }   
 
 // while - jump to the end of the while loop if the condition is false
 void codegen_while_do(instruction *inst) {
-    printf("POPS %cF@$cond_%s$\n", inst->frame, inst->name);
-    printf("JUMPIFEQ end_%s %cF@$cond_%s$ bool@false\n", inst->name, inst->frame, inst->name);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_str(inst->name); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("JUMPIFEQ end_"); emit_str(inst->name); emit_char(' '); emit_frame(inst->frame); EMIT_LITERAL("$cond_"); emit_str(inst->name); EMIT_LITERAL("$ bool@false\n");
 }
 
 void codegen_while_end(instruction *inst) {
-    printf("JUMP %s\n", inst->name);
-    printf("LABEL end_%s\n", inst->name);
+    EMIT_LITERAL("JUMP "); emit_str(inst->name); emit_char('\n');
+    EMIT_LITERAL("LABEL end_"); emit_str(inst->name); emit_char('\n');
 }
 
 // built-in functions
 void codegen_readString(instruction *inst) {
-    printf("JUMP !!skip_readString\n");
-    printf("LABEL readString\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("READ LF@$retval$ string\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_readString\n");
+    EMIT_LITERAL("JUMP !!skip_readString\n");
+    EMIT_LITERAL("LABEL readString\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("READ LF@$retval$ string\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_readString\n");
 }
 
 void codegen_readInt(instruction *inst) {
-    printf("JUMP !!skip_readInt\n");
-    printf("LABEL readInt\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("READ LF@$retval$ int\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_readInt\n");
+    EMIT_LITERAL("JUMP !!skip_readInt\n");
+    EMIT_LITERAL("LABEL readInt\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("READ LF@$retval$ int\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_readInt\n");
 }
 
 void codegen_readDouble(instruction *inst) {
-    printf("JUMP !!skip_readDouble\n");
-    printf("LABEL readDouble\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("READ LF@$retval$ float\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_readDouble\n");
+    EMIT_LITERAL("JUMP !!skip_readDouble\n");
+    EMIT_LITERAL("LABEL readDouble\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("READ LF@$retval$ float\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_readDouble\n");
 }
 
 void codegen_write(instruction *inst) {
-    printf("CREATEFRAME\n");
-    printf("PUSHFRAME\n");
+    EMIT_LITERAL("CREATEFRAME\n");
+    EMIT_LITERAL("PUSHFRAME\n");
     // get the arguments from the stack and print them in the correct order
     for (int i = 1; i <= inst->cnt; i++) {
-        printf("DEFVAR LF@$%d\n", write_renamer + i);
-        printf("POPS LF@$%d\n", write_renamer + i);
+        EMIT_LITERAL("DEFVAR LF@$"); emit_int(write_renamer + i); emit_char('\n');
+        EMIT_LITERAL("POPS LF@$"); emit_int(write_renamer + i); emit_char('\n');
     }
     for (int i = inst->cnt; i >= 1; i--) {
-        printf("WRITE LF@$%d\n", write_renamer + i);
+        EMIT_LITERAL("WRITE LF@$"); emit_int(write_renamer + i); emit_char('\n');
     }
     write_renamer += inst->cnt;
-    printf("POPFRAME\n");
+    EMIT_LITERAL("POPFRAME\n");
 }
 
 void codegen_Int2Double(instruction *inst) {
-    printf("JUMP !!skip_Int2Double\n");  
-    printf("LABEL Int2Double\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("INT2FLOAT LF@$retval$ LF@$1\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_Int2Double\n");
+    EMIT_LITERAL("JUMP !!skip_Int2Double\n");
+    EMIT_LITERAL("LABEL Int2Double\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("INT2FLOAT LF@$retval$ LF@$1\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_Int2Double\n");
 }
 
 void codegen_Double2Int(instruction *inst) {  
-    printf("JUMP !!skip_Double2Int\n");
-    printf("LABEL Double2Int\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("FLOAT2INT LF@$retval$ LF@$1\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_Double2Int\n");
+    EMIT_LITERAL("JUMP !!skip_Double2Int\n");
+    EMIT_LITERAL("LABEL Double2Int\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("FLOAT2INT LF@$retval$ LF@$1\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_Double2Int\n");
 }
 
 void codegen_length(instruction *inst) {
-    printf("JUMP !!skip_length\n");
-    printf("LABEL length\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("STRLEN LF@$retval$ LF@$1\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_length\n");
+    EMIT_LITERAL("JUMP !!skip_length\n");
+    EMIT_LITERAL("LABEL length\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("STRLEN LF@$retval$ LF@$1\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_length\n");
 }
 
 void codegen_substring(instruction *inst) {
-    printf("JUMP !!skip_substring\n");
-    printf("LABEL substring\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("MOVE LF@$retval$ string@\n");
-    printf("DEFVAR LF@$tmp1\n");
-    printf("DEFVAR LF@$check\n");
-    printf("MOVE LF@$check bool@false\n"); // retval is nil if:
-    printf("LT LF@$check LF@$2 int@0\n"); // startingAt < 0
-    printf("JUMPIFEQ !!load_nil LF@$check bool@true\n");
-    printf("LT LF@$check LF@$3 int@0\n"); // endingBefore < 0
-    printf("JUMPIFEQ !!load_nil LF@$check bool@true\n");
-    printf("GT LF@$check LF@$2 LF@$3\n"); // startingAt > endingBefore
-    printf("JUMPIFEQ !!load_nil LF@$check bool@true\n");
-    printf("EQ LF@$check LF@$2 LF@$3\n"); 
-    printf("JUMPIFEQ !!load_result LF@$check bool@true\n");
-    printf("DEFVAR LF@$tmp_strlen\n"); 
-    printf("STRLEN LF@$tmp_strlen LF@$1\n");
-    printf("GT LF@$check LF@$2 LF@$tmp_strlen\n"); // startingAt > strlen
-    printf("JUMPIFEQ !!load_nil LF@$check bool@true\n");
-    printf("EQ LF@$check LF@$2 LF@$tmp_strlen\n"); // startingAt == strlen 
-    printf("JUMPIFEQ !!load_nil LF@$check bool@true\n");
-    printf("GT LF@$check LF@$3 LF@$tmp_strlen\n"); // endingBefore > strlen
-    printf("JUMPIFEQ !!load_nil LF@$check bool@true\n");
-    printf("LABEL !!substring_loop\n");
-    printf("GETCHAR LF@$tmp1 LF@$1 LF@$2\n");
-    printf("CONCAT LF@$retval$ LF@$retval$ LF@$tmp1\n");
-    printf("ADD LF@$2 LF@$2 int@1\n");
-    printf("JUMPIFNEQ !!substring_loop LF@$2 LF@$3\n");
-    printf("JUMP !!load_result\n");
-    printf("LABEL !!load_nil\n"); // load nil if any of the conditions above is true
-    printf("MOVE LF@$retval$ nil@nil\n");
-    printf("LABEL !!load_result\n"); // load result, if startingAt == endingBefore, it's empty string
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_substring\n");
+    EMIT_LITERAL("JUMP !!skip_substring\n");
+    EMIT_LITERAL("LABEL substring\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("MOVE LF@$retval$ string@\n");
+    EMIT_LITERAL("DEFVAR LF@$tmp1\n");
+    EMIT_LITERAL("DEFVAR LF@$check\n");
+    EMIT_LITERAL("MOVE LF@$check bool@false\n"); // retval is nil if:
+    EMIT_LITERAL("LT LF@$check LF@$2 int@0\n"); // startingAt < 0
+    EMIT_LITERAL("JUMPIFEQ !!load_nil LF@$check bool@true\n");
+    EMIT_LITERAL("LT LF@$check LF@$3 int@0\n"); // endingBefore < 0
+    EMIT_LITERAL("JUMPIFEQ !!load_nil LF@$check bool@true\n");
+    EMIT_LITERAL("GT LF@$check LF@$2 LF@$3\n"); // startingAt > endingBefore
+    EMIT_LITERAL("JUMPIFEQ !!load_nil LF@$check bool@true\n");
+    EMIT_LITERAL("EQ LF@$check LF@$2 LF@$3\n");
+    EMIT_LITERAL("JUMPIFEQ !!load_result LF@$check bool@true\n");
+    EMIT_LITERAL("DEFVAR LF@$tmp_strlen\n");
+    EMIT_LITERAL("STRLEN LF@$tmp_strlen LF@$1\n");
+    EMIT_LITERAL("GT LF@$check LF@$2 LF@$tmp_strlen\n"); // startingAt > strlen
+    EMIT_LITERAL("JUMPIFEQ !!load_nil LF@$check bool@true\n");
+    EMIT_LITERAL("EQ LF@$check LF@$2 LF@$tmp_strlen\n"); // startingAt == strlen
+    EMIT_LITERAL("JUMPIFEQ !!load_nil LF@$check bool@true\n");
+    EMIT_LITERAL("GT LF@$check LF@$3 LF@$tmp_strlen\n"); // endingBefore > strlen
+    EMIT_LITERAL("JUMPIFEQ !!load_nil LF@$check bool@true\n");
+    EMIT_LITERAL("LABEL !!substring_loop\n");
+    EMIT_LITERAL("GETCHAR LF@$tmp1 LF@$1 LF@$2\n");
+    EMIT_LITERAL("CONCAT LF@$retval$ LF@$retval$ LF@$tmp1\n");
+    EMIT_LITERAL("ADD LF@$2 LF@$2 int@1\n");
+    EMIT_LITERAL("JUMPIFNEQ !!substring_loop LF@$2 LF@$3\n");
+    EMIT_LITERAL("JUMP !!load_result\n");
+    EMIT_LITERAL("LABEL !!load_nil\n"); // load nil if any of the conditions above is true
+    EMIT_LITERAL("MOVE LF@$retval$ nil@nil\n");
+    EMIT_LITERAL("LABEL !!load_result\n"); // load result, if startingAt == endingBefore, it's empty string
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_substring\n");
 }
 
 void codegen_ord(instruction *inst) {
-    printf("JUMP !!skip_ord\n");
-    printf("LABEL ord\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("JUMPIFNEQ !!valid_param LF@$1 string@\n");
-    printf("MOVE LF@$retval$ int@0\n");
-    printf("JUMP !!end_ord\n");
-    printf("LABEL !!valid_param\n");
-    printf("STRI2INT LF@$retval$ LF@$1 int@0\n");
-    printf("LABEL !!end_ord\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_ord\n");  
+    EMIT_LITERAL("JUMP !!skip_ord\n");
+    EMIT_LITERAL("LABEL ord\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("JUMPIFNEQ !!valid_param LF@$1 string@\n");
+    EMIT_LITERAL("MOVE LF@$retval$ int@0\n");
+    EMIT_LITERAL("JUMP !!end_ord\n");
+    EMIT_LITERAL("LABEL !!valid_param\n");
+    EMIT_LITERAL("STRI2INT LF@$retval$ LF@$1 int@0\n");
+    EMIT_LITERAL("LABEL !!end_ord\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_ord\n");
 }
 
 void codegen_chr(instruction *inst) {
-    printf("JUMP !!skip_chr\n");
-    printf("LABEL chr\n");
-    printf("PUSHFRAME\n");
-    printf("DEFVAR LF@$retval$\n");
-    printf("INT2CHAR LF@$retval$ LF@$1\n");
-    printf("POPFRAME\n");
-    printf("RETURN\n");
-    printf("LABEL !!skip_chr\n");
+    EMIT_LITERAL("JUMP !!skip_chr\n");
+    EMIT_LITERAL("LABEL chr\n");
+    EMIT_LITERAL("PUSHFRAME\n");
+    EMIT_LITERAL("DEFVAR LF@$retval$\n");
+    EMIT_LITERAL("INT2CHAR LF@$retval$ LF@$1\n");
+    EMIT_LITERAL("POPFRAME\n");
+    EMIT_LITERAL("RETURN\n");
+    EMIT_LITERAL("LABEL !!skip_chr\n");
 }
 
 // main function - start of the program
 void codegen_main(instruction *inst) {
-    printf(".IFJcode23\n");
-    printf("CREATEFRAME\n");
-    printf("PUSHFRAME\n");
+    EMIT_LITERAL(".IFJcode23\n");
+    EMIT_LITERAL("CREATEFRAME\n");
+    EMIT_LITERAL("PUSHFRAME\n");
 }
 
 // vardefs in the following functions are separated in case of while loop:
 // concatenation of two strings,
 void codegen_concat(instruction *inst) {
-    printf("POPS %cF@$$s%d$$\n", inst->frame, inst->cnt + 1);
-    printf("POPS %cF@$$s%d$$\n", inst->frame, inst->cnt);
-    printf("CONCAT %cF@$$s%d$$ %cF@$$s%d$$ %cF@$$s%d$$\n", inst->frame, inst->cnt, inst->frame, inst->cnt, inst->frame, inst->cnt + 1);
-    printf("PUSHS %cF@$$s%d$$\n", inst->frame, inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("CONCAT "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt); EMIT_LITERAL("$$ "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt); EMIT_LITERAL("$$ "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$s"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
 }
 
 // int to float conversion
 void codegen_int2floats(instruction *inst) {
-    printf("POPS %cF@$$tmp%d$$\n", inst->frame, inst->cnt);
-    printf("INT2FLOATS\n");
-    printf("PUSHS %cF@$$tmp%d$$\n", inst->frame, inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$tmp"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("INT2FLOATS\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$tmp"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
 }
 
 // exclamation rule
 void codegen_exclamation_rule(instruction *inst) {
-    printf("POPS %cF@$$excl%d\n", inst->frame, inst->cnt);
-    printf("PUSHS %cF@$$excl%d\n", inst->frame, inst->cnt);
-    printf("PUSHS nil@nil\n");
-    printf("JUMPIFNEQS $RULE_EXCL_CORRECT%d$\n", inst->cnt);
-    printf("LABEL $RULE_EXCL_ERROR%d$\n", inst->cnt);
-    printf("WRITE string@Variable\\032is\\032NULL\n");
-    printf("EXIT int@7\n");
-    printf("LABEL $RULE_EXCL_CORRECT%d$\n", inst->cnt);
-    printf("PUSHS %cF@$$excl%d\n", inst->frame, inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$excl"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$excl"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("PUSHS nil@nil\n");
+    EMIT_LITERAL("JUMPIFNEQS $RULE_EXCL_CORRECT"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("LABEL $RULE_EXCL_ERROR"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("WRITE string@Variable\\032is\\032NULL\n");
+    EMIT_LITERAL("EXIT int@7\n");
+    EMIT_LITERAL("LABEL $RULE_EXCL_CORRECT"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$excl"); emit_int(inst->cnt); emit_char('\n');
 }
 
 // less than equal rule
 void codegen_leq_rule(instruction *inst) {
-    printf("POPS %cF@$$leq%d$$\n", inst->frame, inst->cnt);
-    printf("EQS\n");
-    printf("POPS %cF@$$leq%d$$\n", inst->frame, inst->cnt + 1);
-    printf("PUSHS %cF@$$leq%d$$\n", inst->frame, inst->cnt);
-    printf("PUSHS %cF@$$leq%d$$\n", inst->frame, inst->cnt + 1);
-    printf("ORS\n");
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$leq"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("EQS\n");
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$leq"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$leq"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$leq"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("ORS\n");
 }
 
 // greater than equal rule
 void codegen_geq_rule(instruction *inst) {
-    printf("POPS %cF@$$geq%d$$\n", inst->frame, inst->cnt);
-    printf("EQS\n");
-    printf("POPS %cF@$$geq%d$$\n", inst->frame, inst->cnt + 1);
-    printf("PUSHS %cF@$$geq%d$$\n", inst->frame, inst->cnt);
-    printf("PUSHS %cF@$$geq%d$$\n", inst->frame, inst->cnt + 1);
-    printf("ORS\n");
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$geq"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("EQS\n");
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$geq"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$geq"); emit_int(inst->cnt); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$geq"); emit_int(inst->cnt + 1); EMIT_LITERAL("$$\n");
+    EMIT_LITERAL("ORS\n");
 }
 
 // question mark rule
 void codegen_qms_rule(instruction *inst) {
-    printf("POPS %cF@$$rule_qms%d\n", inst->frame, inst->cnt);
-    printf("POPS %cF@$$rule_qms%d\n", inst->frame, inst->cnt + 1);
-    printf("PUSHS %cF@$$rule_qms%d\n", inst->frame, inst->cnt + 1);
-    printf("PUSHS nil@nil\n");
-    printf("JUMPIFNEQS $RULE_QMS_NOT_NILL%d$\n", inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt + 1); emit_char('\n');
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt + 1); emit_char('\n');
+    EMIT_LITERAL("PUSHS nil@nil\n");
+    EMIT_LITERAL("JUMPIFNEQS $RULE_QMS_NOT_NILL"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
 
-    printf("LABEL $RULE_QMS_NILL%d$\n", inst->cnt);
-    printf("PUSHS %cF@$$rule_qms%d\n", inst->frame, inst->cnt);
-    printf("JUMP $END_RULE_QMS%d$\n",  inst->cnt);
+    EMIT_LITERAL("LABEL $RULE_QMS_NILL"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("JUMP $END_RULE_QMS"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
 
-    printf("LABEL $RULE_QMS_NOT_NILL%d$\n", inst->cnt);
-    printf("PUSHS %cF@$$rule_qms%d\n", inst->frame, inst->cnt + 1);
+    EMIT_LITERAL("LABEL $RULE_QMS_NOT_NILL"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("$$rule_qms"); emit_int(inst->cnt + 1); emit_char('\n');
 
-    printf("LABEL $END_RULE_QMS%d$\n",  inst->cnt);
+    EMIT_LITERAL("LABEL $END_RULE_QMS"); emit_int(inst->cnt); EMIT_LITERAL("$\n");
 }
 
 // checking division by zero for integers
 void codegen_idiv_zero(instruction *inst) {
-    printf("POPS %cF@idiv_zero_%d\n", inst->frame, inst->cnt);
-    printf("JUMPIFNEQ !!SKIP_IDIV_BY_ZERO%d %cF@%s%d int@0\n", inst->cnt, inst->frame, inst->name, inst->cnt);
-    printf("EXIT int@7\n");
-    printf("LABEL !!SKIP_IDIV_BY_ZERO%d\n", inst->cnt);
-    printf("PUSHS %cF@idiv_zero_%d\n", inst->frame, inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("idiv_zero_"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("JUMPIFNEQ !!SKIP_IDIV_BY_ZERO"); emit_int(inst->cnt); emit_char(' '); emit_frame(inst->frame); emit_str(inst->name); emit_int(inst->cnt); EMIT_LITERAL(" int@0\n");
+    EMIT_LITERAL("EXIT int@7\n");
+    EMIT_LITERAL("LABEL !!SKIP_IDIV_BY_ZERO"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("idiv_zero_"); emit_int(inst->cnt); emit_char('\n');
 }
 
 // checking division by zero for floats
 void codegen_div_zero(instruction *inst) {
-    printf("POPS %cF@div_zero_%d\n", inst->frame, inst->cnt);
-    printf("JUMPIFNEQ !!SKIP_DIV_BY_ZERO%d %cF@%s%d float@0x0p+0\n", inst->cnt, inst->frame, inst->name, inst->cnt);
-    printf("EXIT int@7\n");
-    printf("LABEL !!SKIP_DIV_BY_ZERO%d\n", inst->cnt);
-    printf("PUSHS %cF@div_zero_%d\n", inst->frame, inst->cnt);
+    EMIT_LITERAL("POPS "); emit_frame(inst->frame); EMIT_LITERAL("div_zero_"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("JUMPIFNEQ !!SKIP_DIV_BY_ZERO"); emit_int(inst->cnt); emit_char(' '); emit_frame(inst->frame); emit_str(inst->name); emit_int(inst->cnt); EMIT_LITERAL(" float@0x0p+0\n");
+    EMIT_LITERAL("EXIT int@7\n");
+    EMIT_LITERAL("LABEL !!SKIP_DIV_BY_ZERO"); emit_int(inst->cnt); emit_char('\n');
+    EMIT_LITERAL("PUSHS "); emit_frame(inst->frame); EMIT_LITERAL("div_zero_"); emit_int(inst->cnt); emit_char('\n');
 }
 
@@ -3,7 +3,7 @@
  *
  * IFJ23 compiler
  *
- * @brief Generator of IFJcode23 with doubly linked list of instructions
+ * @brief Generator of IFJcode23, instructions live in one growable buffer linked by their indices
  *
  * @author Marek Effenberger <xeffen00>
  * @author Adam Valík <xvalik05>
@@ -84,12 +84,12 @@ typedef enum instruction_type {
 } inst_type;
 
 
-// Structure of instruction holding its informations
-typedef struct s_instruction {
-	struct s_instruction *prev; // previous instruction
-	struct s_instruction *next; // next instruction
+#define INST_NONE -1 // index of no instruction
 
-    forest_node *relevant_node; // relevant node from forest
+// Structure of instruction holding its informations, instructions are linked by their indices in the buffer
+typedef struct s_instruction {
+    int prev; // index of previous instruction, INST_NONE for the first one
+    int next; // index of next instruction, INST_NONE for the last one
 
     inst_type inst_type; // type of instruction
 
@@ -98,19 +98,35 @@ typedef struct s_instruction {
     char *name; // name of variable or function
     int cnt; // counter for relevant naming
 
-    int int_value;
-    double float_value;
-    char *string_value;
+    long long int_value; // value of int constant, length of string constant
+    // Each type of instruction uses one of these at most
+    union {
+        double float_value;
+        char *string_value;
+        forest_node *relevant_node; // relevant node from forest, used by function definition
+    };
 } instruction;
 
 
-// Structure of instruction list element
+// Structure of instruction list, the instructions live in one growable buffer
 typedef struct {
-	instruction *first;
-	instruction *active;
-	instruction *last;
+    instruction *insts; // buffer of the instructions in order of their creation
+    int count; // number of used slots of the buffer
+    int capacity;
+    int first; // indices of the instructions in the buffer
+    int active;
+    int last;
+    int emitted; // last instruction already generated in streaming mode, INST_NONE if none
+    char **names; // names allocated for the instructions, freed together with them
+    int names_count;
+    int names_capacity;
 } instruction_list;
 
+#define CODEGEN_PIPE_CAPACITY 16 // number of instruction batches in flight between the parser and the emitter thread, power of two
+
+extern bool codegen_stream_enabled; // code is generated after each top-level statement or function definition
+extern bool codegen_pipe_enabled; // in streaming mode the code is generated on own thread behind the parser
+
 
 /**
  * @brief Instruction list initialization
@@ -122,6 +138,7 @@ void inst_list_init(instruction_list *list);
 /**
  * @brief Instruction initialization - sets the relevant informations and the rest to default
  * 
+ * @note The instruction is returned by value, insertion copies it into the buffer of the list
  * @param type Type of instruction
  * @param frame G(F), L(F)
  * @param name Name of variable or function
@@ -129,13 +146,13 @@ void inst_list_init(instruction_list *list);
  * @param int_value Integer value
  * @param float_value Float value
  * @param string_value String value
- * @return instruction* 
+ * @return instruction Initialized instruction, not linked anywhere yet
  */
-instruction* inst_init(inst_type type,
+instruction inst_init(inst_type type,
                         char frame,
                         char *name,
                         int cnt,
-                        int int_value,
+                        long long int_value,
                         double float_value,
                         char *string_value);
 
@@ -144,7 +161,7 @@ instruction* inst_init(inst_type type,
  * @brief Insert instruction at the end of the list
  * 
  * @param list Instruction list
- * @param new_inst Instruction to be inserted
+ * @param new_inst Instruction to be inserted, it is copied into the buffer
  */
 void inst_list_insert_last(instruction_list *list, instruction *new_inst);
 
@@ -152,16 +169,17 @@ void inst_list_insert_last(instruction_list *list, instruction *new_inst);
  * @brief Insert instruction before the active instruction
  * 
  * @param list Instruction list
- * @param new_inst Instruction to be inserted
+ * @param new_inst Instruction to be inserted, it is copied into the buffer
  */
 void inst_list_insert_before(instruction_list *list, instruction *new_inst);
 
 /**
- * @brief Delete instruction after the active instruction
+ * @brief Hand over the name allocated for the instructions, it is freed when they are not needed anymore
  * 
  * @param list Instruction list
+ * @param name Name allocated by allocate_memory
  */
-void inst_list_delete_after(instruction_list *list);
+void inst_list_own_name(instruction_list *list, char *name);
 
 /**
  * @brief Dispose of the whole instruction list
@@ -171,27 +189,47 @@ void inst_list_delete_after(instruction_list *list);
 void inst_list_dispose(instruction_list *list);
 
 /**
- * @brief Search for the outermost while instruction
+ * @brief Set the active instruction, instructions can be inserted before it then
  * 
  * @param list Instruction list
- * @param while_name Name of the while instruction
+ * @param index Index of the instruction, usually an anchor remembered when it was inserted
  */
-void inst_list_search_while(instruction_list *list, char *while_name);
+void inst_list_activate(instruction_list *list, int index);
 
 /**
- * @brief Search for the void function calls to remove the return value
+ * @brief Goes through the instruction list and generates the IFJcode23 for each instruction
  * 
+ * @note The emitter thread is stopped first, it generates the instructions handed over to it before
  * @param list Instruction list
- * @param func_name Name of the function
  */
-void inst_list_search_void_func_call(instruction_list *list, char *func_name);
+void codegen_generate_code_please(instruction_list *list);
 
 /**
- * @brief Goes through the instruction list and generates the IFJcode23 for each instruction
+ * @brief Start the emitter thread if the code is streamed and the pipe is enabled
+ */
+void codegen_pipe_start();
+
+/**
+ * @brief Wait for the emitter thread to generate all the instructions handed over to it and stop it
+ */
+void codegen_pipe_stop();
+
+/**
+ * @brief Generates the IFJcode23 for the instructions not generated yet and frees them, used in streaming mode
  * 
+ * @note The last instruction is kept so that new instructions can be appended to it, it is marked as emitted.
+ *       When the emitter thread runs, the instructions are handed over to it and generated there.
  * @param list Instruction list
  */
-void codegen_generate_code_please(instruction_list *list);
+void codegen_generate_pending(instruction_list *list);
+
+/**
+ * @brief Prints the value of string constant, characters up to space, '#' and '\\' are printed as \\ddd escape sequences
+ * 
+ * @param str Value of the string, it can contain null characters
+ * @param length Length of the value
+ */
+void codegen_string_const(const char *str, int length);
 
 /**
  * @brief Helping functions for generating the IFJcode23 to separate larger blocks of printing
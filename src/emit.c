@@ -0,0 +1,164 @@
+/**
+ * @file emit.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Buffered output of the generated code without format strings
+ *
+ * @author Marek Effenberger <xeffen00>
+ * @author Adam Valík <xvalik05>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static struct emit_buffer {
+    char data[EMIT_BUFFER_SIZE];
+    size_t used;
+} output = {.used = 0};
+
+// Write all the parts to stdout, writev can write just a part of them
+static void emit_write(struct iovec *parts, int count) {
+    while (count > 0) {
+        ssize_t written = writev(STDOUT_FILENO, parts, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_exit(ERROR_INTERNAL, "CODEGEN", "Writing of the generated code failed");
+        }
+        while (count > 0 && (size_t)written >= parts->iov_len) {
+            written -= parts->iov_len;
+            parts++;
+            count--;
+        }
+        if (count > 0) {
+            parts->iov_base = (char*)parts->iov_base + written;
+            parts->iov_len -= written;
+        }
+    }
+}
+
+void emit_mem(const char *str, size_t length) {
+    if (length <= EMIT_BUFFER_SIZE - output.used) {
+        memcpy(output.data + output.used, str, length);
+        output.used += length;
+        return;
+    }
+
+    // Characters which do not fit are written right behind the buffer by the same system call
+    struct iovec parts[2] = {{output.data, output.used}, {(void*)str, length}};
+    emit_write(parts, 2);
+    output.used = 0;
+}
+
+void emit_str(const char *str) {
+    emit_mem(str, strlen(str));
+}
+
+void emit_char(char c) {
+    if (output.used == EMIT_BUFFER_SIZE) {
+        emit_flush();
+    }
+    output.data[output.used++] = c;
+}
+
+void emit_frame(char frame) {
+    char prefix[3] = {frame, 'F', '@'};
+    emit_mem(prefix, sizeof(prefix));
+}
+
+void emit_int(long long value) {
+    char digits[21];
+    char *p = digits + sizeof(digits);
+    // LLONG_MIN has no positive counterpart in long long
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+
+    do {
+        *--p = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        *--p = '-';
+    }
+    emit_mem(p, digits + sizeof(digits) - p);
+}
+
+void emit_float(double value) {
+    static const char hex[] = "0123456789abcdef";
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int exponent = (int)((bits >> 52) & 0x7ff);
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+
+    // Infinity and NaN cannot come from literals, printf spells them out
+    if (exponent == 0x7ff) {
+        char text[8];
+        int length = snprintf(text, sizeof(text), "%a", value);
+        emit_mem(text, length);
+        return;
+    }
+
+    char text[32];
+    int length = 0;
+    if (bits >> 63) {
+        text[length++] = '-';
+    }
+    text[length++] = '0';
+    text[length++] = 'x';
+
+    // Subnormal numbers and zero have leading digit 0, the exponent of subnormals is the smallest one
+    if (exponent == 0) {
+        text[length++] = '0';
+        exponent = mantissa == 0 ? 0 : -1022;
+    }
+    else {
+        text[length++] = '1';
+        exponent -= 1023;
+    }
+
+    // 13 hex digits of the mantissa without trailing zeros
+    if (mantissa != 0) {
+        text[length++] = '.';
+        for (int shift = 48; mantissa != 0; shift -= 4) {
+            text[length++] = hex[(mantissa >> shift) & 0xf];
+            mantissa &= (1ULL << shift) - 1;
+        }
+    }
+
+    text[length++] = 'p';
+    text[length++] = exponent < 0 ? '-' : '+';
+    emit_mem(text, length);
+    emit_int(exponent < 0 ? -exponent : exponent);
+}
+
+void emit_flush() {
+    struct iovec part = {output.data, output.used};
+    emit_write(&part, 1);
+    output.used = 0;
+}
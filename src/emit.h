@@ -0,0 +1,70 @@
+/**
+ * @file emit.h
+ *
+ * IFJ23 compiler
+ *
+ * @brief Buffered output of the generated code without format strings
+ *
+ * @author Marek Effenberger <xeffen00>
+ * @author Adam Valík <xvalik05>
+ */
+
+#ifndef IFJ_EMIT_H
+#define IFJ_EMIT_H
+
+#include <stddef.h>
+
+#define EMIT_BUFFER_SIZE (1 << 20) // size of the buffer of the generated code, it is written to stdout when full
+
+// Append string literal, its length is known at compile time
+#define EMIT_LITERAL(str) emit_mem((str), sizeof(str) - 1)
+
+/**
+ * @brief Append characters to the output
+ *
+ * @param str Characters, they do not have to be null terminated
+ * @param length Number of the characters
+ */
+void emit_mem(const char *str, size_t length);
+
+/**
+ * @brief Append null terminated string to the output
+ *
+ * @param str String, usually name of variable, function or label
+ */
+void emit_str(const char *str);
+
+/**
+ * @brief Append one character to the output
+ *
+ * @param c Character
+ */
+void emit_char(char c);
+
+/**
+ * @brief Append prefix of variable in the frame
+ *
+ * @param frame 'G', 'L' or 'T', the prefix is GF@, LF@ or TF@
+ */
+void emit_frame(char frame);
+
+/**
+ * @brief Append integer in decimal
+ *
+ * @param value Integer, int of IFJcode23 has 64 bits
+ */
+void emit_int(long long value);
+
+/**
+ * @brief Append double in hexadecimal notation, the same as printf %a prints it
+ *
+ * @param value Double
+ */
+void emit_float(double value);
+
+/**
+ * @brief Write the buffered output to stdout
+ */
+void emit_flush();
+
+#endif //IFJ_EMIT_H
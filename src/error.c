@@ -12,14 +12,20 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 
 
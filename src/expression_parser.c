@@ -11,14 +11,20 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 
 #define TABLE_SIZE 16 //Number of lines and columns in precedence table
@@ -129,12 +135,7 @@ int get_index(token_type_t token){
 }
 
 token_t* token_create(token_type_t token_type){
-    token_t* token = (token_t*)allocate_memory(sizeof(token_t));
-    token->value.vector = NULL;
-    token->value.integer = 0;
-    token->value.type_double = 0.0;
-    token->type = token_type;
-    return token;
+    return token_arena_token(token_type);
 }
 
 
@@ -258,8 +259,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
 
                 // CODEGEN
                 vardef_outermost_while(CONCAT_DEFVAR, NULL, variable_counter);
-                instruction *inst = inst_init(CONCAT, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(CONCAT, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
 
                 variable_counter++;
                 variable_counter++;
@@ -275,8 +276,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if(tmp3->exp_value == DOUBLE || tmp3->exp_value == DOUBLE_QM){
                         
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         tmp1->exp_value = DOUBLE;
                     } else {
@@ -291,8 +292,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if (tmp1->exp_value == INT || tmp1->exp_value == INT_QM){
                         
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         tmp1->exp_value = DOUBLE;
                     }
@@ -300,8 +301,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         variable_counter++;
                     }
@@ -312,8 +313,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                         
                         variable_counter++;
                     } else {
@@ -329,8 +330,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if (tmp1->exp_value == INT || tmp1->exp_value == INT_QM){
                         
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         tmp1->exp_value = DOUBLE;
                     }
@@ -338,8 +339,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                         
                         variable_counter++;
                     }
@@ -385,10 +386,10 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
 
                 // CODEGEN
                 vardef_outermost_while(IDIV_ZERO_DEFVAR, NULL, variable_counter);
-                instruction *inst_zero = inst_init(IDIV_BY_ZERO, active->frame, "idiv_zero_", variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst_zero);
-                instruction *inst = inst_init(IDIVS, 'G', NULL, variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst_zero = inst_init(IDIV_BY_ZERO, active->frame, "idiv_zero_", variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst_zero);
+                instruction inst = inst_init(IDIVS, 'G', NULL, variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 
                 variable_counter++;
             //Tokens are floats, it is gonna be div
@@ -396,10 +397,10 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                 
                 // CODEGEN
                 vardef_outermost_while(DIV_ZERO_DEFVAR, NULL, variable_counter);
-                instruction *inst_zero = inst_init(DIV_BY_ZERO, active->frame, "div_zero_", variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst_zero);
-                instruction *inst = inst_init(DIVS, 'G', NULL, variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst_zero = inst_init(DIV_BY_ZERO, active->frame, "div_zero_", variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst_zero);
+                instruction inst = inst_init(DIVS, 'G', NULL, variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
 
                 variable_counter++;
 
@@ -418,12 +419,12 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if(tmp3->exp_value == DOUBLE){
 
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         // CODEGEN
-                        instruction *inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst1);
+                        instruction inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst1);
 
                         tmp1->exp_value = DOUBLE;
                     } else {
@@ -437,12 +438,12 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if (tmp1->exp_value == INT){
 
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         // CODEGEN
-                        instruction *inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst1);
+                        instruction inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst1);
 
                         tmp1->exp_value = DOUBLE;
                     }
@@ -450,12 +451,12 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                       
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         // CODEGEN
-                        instruction *inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst1);
+                        instruction inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst1);
 
                         variable_counter++;
                     }
@@ -467,12 +468,12 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         // CODEGEN
-                        instruction *inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst1);
+                        instruction inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst1);
 
                         variable_counter++;
                     } else {
@@ -487,12 +488,12 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if (tmp1->exp_value == INT){
                         
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         // CODEGEN
-                        instruction *inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst1);
+                        instruction inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst1);
 
                         tmp1->exp_value = DOUBLE;
                     }
@@ -500,12 +501,12 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
 
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         // CODEGEN
-                        instruction *inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst1);
+                        instruction inst1 = inst_init(DIVS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst1);
 
                         variable_counter++;
                     }
@@ -581,8 +582,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if(tmp3->exp_value == DOUBLE && tmp1->exp_value == INT){
                         
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         tmp1->exp_value = BOOL;
                     } else {
@@ -593,8 +594,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if (tmp1->exp_value == INT && tmp3->exp_value == DOUBLE){
 
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         tmp1->exp_value = BOOL;
                     }
@@ -602,8 +603,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                         
                         tmp1->exp_value = BOOL;
                         variable_counter++;
@@ -616,8 +617,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                         
                         tmp1->exp_value = BOOL;
                         variable_counter++;
@@ -629,8 +630,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                     if (tmp1->exp_value == INT && tmp3->exp_value == DOUBLE){
                         
                         // CODEGEN
-                        instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                         
                         tmp1->exp_value = BOOL;
                     }
@@ -638,8 +639,8 @@ void check_types(token_t* tmp1, token_t* tmp2, token_t* tmp3){
                         
                         // CODEGEN
                         vardef_outermost_while(INT2FLOATS_2_DEFVAR, NULL, variable_counter);
-                        instruction *inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(INT2FLOATS_2, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                         
                         tmp1->exp_value = BOOL;
                         variable_counter++;
@@ -659,54 +660,58 @@ void push_for_leq_geq(token_t* tmp1, token_t* tmp3){
     if (tmp3->exp_type == CONST){
         if (tmp3->exp_value == INT){                                    
             // CODEGEN
-            instruction *inst = inst_init(PUSHS_INT_CONST, 'G', NULL, 0, tmp3->value.integer, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(PUSHS_INT_CONST, 'G', NULL, 0, tmp3->value.integer, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
         } else if (tmp3->exp_value == DOUBLE){
             // CODEGEN
-            instruction *inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp3->value.type_double, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp3->value.type_double, NULL);
+            inst_list_insert_last(inst_list, &inst);
         } else if (tmp3->exp_value == STRING){
             // CODEGEN
-            char *string = allocate_memory(strlen(tmp3->value.vector->array)+1); // new memory has to be allocated for string
-            instruction *inst = inst_init(PUSHS_STRING_CONST, 'G', NULL, 0, 0, 0.0, strcpy(string, tmp3->value.vector->array));
-            inst_list_insert_last(inst_list, inst);
+            char *string = allocate_memory(tmp3->value.length+1); // new memory has to be allocated for string, lexeme is not terminated and can contain null characters
+            memcpy(string, tmp3->value.lexeme, tmp3->value.length);
+            string[tmp3->value.length] = '\0';
+            instruction inst = inst_init(PUSHS_STRING_CONST, 'G', NULL, 0, tmp3->value.length, 0.0, string);
+            inst_list_insert_last(inst_list, &inst);
 
         }
     } else {
-        forest_node* scope = forest_search_scope(active, tmp3->value.vector->array);
-        AVL_tree* node = forest_search_symbol(active, tmp3->value.vector->array);
+        forest_node* scope = forest_search_scope(tmp3->value.name);
+        AVL_tree* node = forest_search_symbol(tmp3->value.name);
         char *nickname = renamer(node);
         if (tmp3->exp_value == INT || tmp3->exp_value == DOUBLE || tmp3->exp_value == STRING){
             // CODEGEN
-            instruction *inst = inst_init(PUSHS, scope->frame, nickname, 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(PUSHS, scope->frame, nickname, 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
         }
     }
 
     if (tmp1->exp_type == CONST){
         if (tmp1->exp_value == INT){
             // CODEGEN
-            instruction *inst = inst_init(PUSHS_INT_CONST, 'G', NULL, 0, tmp1->value.integer, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(PUSHS_INT_CONST, 'G', NULL, 0, tmp1->value.integer, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
         } else if (tmp1->exp_value == DOUBLE){
             // CODEGEN
-            instruction *inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp1->value.type_double, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp1->value.type_double, NULL);
+            inst_list_insert_last(inst_list, &inst);
         } else if (tmp1->exp_value == STRING){
             // CODEGEN
-            char *string = allocate_memory(strlen(tmp1->value.vector->array)+1); // new memory has to be allocated for string
-            instruction *inst = inst_init(PUSHS_STRING_CONST, 'G', NULL, 0, 0, 0.0, strcpy(string, tmp1->value.vector->array));
-            inst_list_insert_last(inst_list, inst);
+            char *string = allocate_memory(tmp1->value.length+1); // new memory has to be allocated for string, lexeme is not terminated and can contain null characters
+            memcpy(string, tmp1->value.lexeme, tmp1->value.length);
+            string[tmp1->value.length] = '\0';
+            instruction inst = inst_init(PUSHS_STRING_CONST, 'G', NULL, 0, tmp1->value.length, 0.0, string);
+            inst_list_insert_last(inst_list, &inst);
 
         }
     } else {
-        forest_node* scope = forest_search_scope(active, tmp1->value.vector->array);
-        AVL_tree* node = forest_search_symbol(active, tmp1->value.vector->array);
+        forest_node* scope = forest_search_scope(tmp1->value.name);
+        AVL_tree* node = forest_search_symbol(tmp1->value.name);
         char *nickname = renamer(node);
         if (tmp1->exp_value == INT || tmp1->exp_value == DOUBLE || tmp1->exp_value == STRING){
             // CODEGEN
-            instruction *inst = inst_init(PUSHS, scope->frame, nickname, 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(PUSHS, scope->frame, nickname, 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
         }
     }
 }
@@ -762,8 +767,8 @@ void call_expr_parser(data_type return_type) {
             if((return_type != UNKNOWN) && (return_type != stack_top(&stack)->exp_value)){
 
                 if((return_type == DOUBLE || return_type == DOUBLE_QM) && stack_top(&stack)->exp_value == INT && stack_top(&stack)->was_exp == false){
-                    instruction *inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(INT2FLOATS, 'G', NULL, 0, 0, 0.0, NULL);
+                    inst_list_insert_last(inst_list, &inst);
                 } else if(return_type == INT_QM && stack_top(&stack)->exp_value == INT){
                     type_of_expr = INT;
                 } else if(return_type == DOUBLE_QM && stack_top(&stack)->exp_value == DOUBLE){
@@ -844,9 +849,9 @@ void call_expr_parser(data_type return_type) {
             case RULE_OPERAND:
 
                 if(tmp1->type == TOKEN_ID){
-                    forest_node* forest = forest_search_scope(active, tmp1->value.vector->array);
+                    forest_node* forest = forest_search_scope(tmp1->value.name);
                     //Search in AVL tree to find node with specific ID
-                    AVL_tree* node = forest_search_symbol(active, tmp1->value.vector->array);
+                    AVL_tree* node = forest_search_symbol(tmp1->value.name);
                     if(node == NULL){
                         error_exit(ERROR_SEM_UNDEF_VAR, "EXPRESSION PARSER", "Variable does not exist");
                     }
@@ -870,16 +875,16 @@ void call_expr_parser(data_type return_type) {
 
                     if(variable_type == INT || variable_type == INT_QM){
                         // CODEGEN
-                        instruction *inst = inst_init(PUSHS, forest->frame, nickname, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(PUSHS, forest->frame, nickname, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                     } else if (variable_type == DOUBLE || variable_type == DOUBLE_QM){
                         // CODEGEN
-                        instruction *inst = inst_init(PUSHS, forest->frame, nickname, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(PUSHS, forest->frame, nickname, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                     } else if(variable_type == STRING || variable_type == STRING_QM){
                         // CODEGEN
-                        instruction *inst = inst_init(PUSHS, forest->frame, nickname, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(PUSHS, forest->frame, nickname, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
                     }
 
                 } else if(tmp1->type == TOKEN_DEC){
@@ -888,8 +893,8 @@ void call_expr_parser(data_type return_type) {
                     tmp1->exp_value = DOUBLE;
                     
                     // CODEGEN
-                    instruction *inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp1->value.type_double, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp1->value.type_double, NULL);
+                    inst_list_insert_last(inst_list, &inst);
 
                 } else if(tmp1->type == TOKEN_NUM){
                     tmp1->type = TOKEN_EXPRESSION;
@@ -897,8 +902,8 @@ void call_expr_parser(data_type return_type) {
                     tmp1->exp_value = INT;
 
                     // CODEGEN
-                    instruction *inst = inst_init(PUSHS_INT_CONST, 'G', NULL, 0, tmp1->value.integer, 0.0, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(PUSHS_INT_CONST, 'G', NULL, 0, tmp1->value.integer, 0.0, NULL);
+                    inst_list_insert_last(inst_list, &inst);
 
                 } else if (tmp1->type == TOKEN_EXP){
                     tmp1->type = TOKEN_EXPRESSION;
@@ -906,8 +911,8 @@ void call_expr_parser(data_type return_type) {
                     tmp1->exp_value = DOUBLE;
                     
                     // CODEGEN
-                    instruction *inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp1->value.type_double, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(PUSHS_FLOAT_CONST, 'G', NULL, 0, 0, tmp1->value.type_double, NULL);
+                    inst_list_insert_last(inst_list, &inst);
 
                 } else if (tmp1->type == TOKEN_STRING || tmp1->type == TOKEN_ML_STRING){
                     tmp1->type = TOKEN_EXPRESSION;
@@ -915,9 +920,11 @@ void call_expr_parser(data_type return_type) {
                     tmp1->exp_value = STRING;
                                         
                     // CODEGEN
-                    char *string = allocate_memory(strlen(tmp1->value.vector->array)+1); // new memory has to be allocated for string
-                    instruction *inst = inst_init(PUSHS_STRING_CONST, 'G', NULL, 0, 0, 0.0, strcpy(string, tmp1->value.vector->array));
-                    inst_list_insert_last(inst_list, inst);
+                    char *string = allocate_memory(tmp1->value.length+1); // new memory has to be allocated for string, lexeme is not terminated and can contain null characters
+                    memcpy(string, tmp1->value.lexeme, tmp1->value.length);
+                    string[tmp1->value.length] = '\0';
+                    instruction inst = inst_init(PUSHS_STRING_CONST, 'G', NULL, 0, tmp1->value.length, 0.0, string);
+                    inst_list_insert_last(inst_list, &inst);
 
                 } else if(tmp1->type == TOKEN_KEYWORD){
                     if(tmp1->value.keyword != KW_NIL){
@@ -929,8 +936,8 @@ void call_expr_parser(data_type return_type) {
                         tmp1->exp_value = NIL;
                     
                         // CODEGEN
-                        instruction *inst = inst_init(PUSHS_NIL, 'G', NULL, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(PUSHS_NIL, 'G', NULL, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                     }
                 } else {
@@ -944,8 +951,8 @@ void call_expr_parser(data_type return_type) {
 
                     // CODEGEN
                     vardef_outermost_while(EXCLAMATION_RULE_DEFVAR, NULL, variable_counter);
-                    instruction *inst = inst_init(EXCLAMATION_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(EXCLAMATION_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                    inst_list_insert_last(inst_list, &inst);
 
                     variable_counter++;
                     //Nillable value is now converted to nonnillable
@@ -974,8 +981,8 @@ void call_expr_parser(data_type return_type) {
                     
                 } else { 
                     // CODEGEN
-                    instruction *inst = inst_init(ADDS, 'G', NULL, 0, 0, 0.0, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(ADDS, 'G', NULL, 0, 0, 0.0, NULL);
+                    inst_list_insert_last(inst_list, &inst);
                 }
 
                 if(tmp1->exp_type == ID || tmp3->exp_type == ID){
@@ -988,8 +995,8 @@ void call_expr_parser(data_type return_type) {
             case RULE_MUL:
                 check_types(tmp1, tmp2, tmp3);
                 // CODEGEN
-                instruction *inst = inst_init(MULS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(MULS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
 
                 if(tmp1->exp_type == ID || tmp3->exp_type == ID){
                     //ID was used in addition, cant be converted later
@@ -1001,8 +1008,8 @@ void call_expr_parser(data_type return_type) {
             case RULE_SUB:
                 check_types(tmp1, tmp2, tmp3);
                 // CODEGEN
-                instruction *inst1 = inst_init(SUBS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst1);
+                instruction inst1 = inst_init(SUBS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst1);
 
                 if(tmp1->exp_type == ID || tmp3->exp_type == ID){
                     //ID was used in addition, cant be converted later
@@ -1024,8 +1031,8 @@ void call_expr_parser(data_type return_type) {
             case RULE_LESS:
                 check_types(tmp1, tmp2, tmp3);
                 // CODEGEN
-                instruction *inst2 = inst_init(LTS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst2);
+                instruction inst2 = inst_init(LTS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst2);
 
                 stack_push(&stack, tmp1);
                 break;
@@ -1036,11 +1043,11 @@ void call_expr_parser(data_type return_type) {
                 check_types(tmp1, tmp2, tmp3);
 
                 // CODEGEN
-                instruction *inst31 = inst_init(LTS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst31);
+                instruction inst31 = inst_init(LTS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst31);
                 vardef_outermost_while(LEQ_RULE_DEFVAR, NULL, variable_counter);
-                instruction *inst3 = inst_init(LEQ_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst3);
+                instruction inst3 = inst_init(LEQ_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst3);
 
                 stack_push(&stack, tmp1);
                 variable_counter++;
@@ -1049,8 +1056,8 @@ void call_expr_parser(data_type return_type) {
             case RULE_GTR:
                 check_types(tmp1, tmp2, tmp3);
                 // CODEGEN
-                instruction *inst4 = inst_init(GTS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst4);
+                instruction inst4 = inst_init(GTS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst4);
 
                 stack_push(&stack, tmp1);
                 break;
@@ -1059,11 +1066,11 @@ void call_expr_parser(data_type return_type) {
                 check_types(tmp1, tmp2, tmp3);
 
                 // CODEGEN
-                instruction *inst51 = inst_init(GTS,'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst51);
+                instruction inst51 = inst_init(GTS,'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst51);
                 vardef_outermost_while(GEQ_RULE_DEFVAR, NULL, variable_counter);
-                instruction *inst5 = inst_init(GEQ_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst5);
+                instruction inst5 = inst_init(GEQ_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst5);
 
                 stack_push(&stack, tmp1);
                 variable_counter++;
@@ -1072,20 +1079,20 @@ void call_expr_parser(data_type return_type) {
             case RULE_EQ:
                 check_types(tmp1, tmp2, tmp3);
                 // CODEGEN
-                instruction *inst6 = inst_init(EQS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst6);
+                instruction inst6 = inst_init(EQS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst6);
 
                 stack_push(&stack, tmp1);
                 break;
             case RULE_NEQ:
                 check_types(tmp1, tmp2, tmp3);
                 // CODEGEN
-                instruction *inst7 = inst_init(EQS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst7);
+                instruction inst7 = inst_init(EQS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst7);
 
                 // CODEGEN
-                instruction *inst8 = inst_init(NOTS, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst8);
+                instruction inst8 = inst_init(NOTS, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst8);
 
                 stack_push(&stack, tmp1);
                 break;
@@ -1101,8 +1108,8 @@ void call_expr_parser(data_type return_type) {
 
                     // CODEGEN
                     vardef_outermost_while(QMS_RULE_DEFVAR, NULL, variable_counter);
-                    instruction *inst = inst_init(QMS_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(QMS_RULE, active->frame, NULL, variable_counter, 0, 0.0, NULL);
+                    inst_list_insert_last(inst_list, &inst);
 
 
                     variable_counter++;
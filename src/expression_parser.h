@@ -49,7 +49,7 @@ int get_index(token_type_t token);
  * @brief Creates new token 
  * 
  * @param token_type specifies type of token to be created
- * @return token_t* pointer to newly allocated token
+ * @return token_t* pointer to new token allocated from the token arena
  */
 token_t* token_create(token_type_t token_type);
 
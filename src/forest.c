@@ -13,60 +13,163 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 #include <string.h>
 
 int forest_node_cnt = -10; // skip built-in functions
 
+// Symbol of the name in one of the scopes of the active node
+typedef struct s_forest_binding {
+    forest_node *scope;
+    AVL_tree *symbol;
+    int shadowed; // binding of the same name in an outer scope, -1 if there is none
+} forest_binding;
+
+// Slot of the name in the index, the name keeps it when no scope has the name anymore
+typedef struct s_forest_index_slot {
+    char *key;
+    unsigned int hash;
+    int top; // binding of the name in the innermost scope, -1 if there is none
+} forest_index_slot;
+
+// Index of the visible symbols, the bindings are pushed and popped as the scopes are entered and left
+static struct forest_index {
+    forest_index_slot *slots;
+    int capacity;
+    int count;
+    forest_binding *bindings; // innermost scope on top
+    int bindings_count;
+    int bindings_capacity;
+} scope_index = {NULL, 0, 0, NULL, 0, 0};
+
+// Nodes of the forest live in blocks next to each other, disposed nodes are reused by the next inserts
+static struct forest_pool {
+    forest_node *blocks[FOREST_POOL_BLOCKS];
+    int block_count;
+    int block_used; // number of the nodes taken from the last block
+    forest_node *free; // disposed nodes linked by their parent pointers
+} node_pool = {{NULL}, 0, 0, NULL};
+
+static forest_node *forest_new_node() {
+    if (node_pool.free != NULL) {
+        forest_node *node = node_pool.free;
+        node_pool.free = node->parent;
+        return node;
+    }
+    if (node_pool.block_count == 0 || node_pool.block_used == FOREST_POOL_INIT << (node_pool.block_count - 1)) {
+        if (node_pool.block_count == FOREST_POOL_BLOCKS) {
+            error_exit(ERROR_INTERNAL, "FOREST", "Too many nodes in the forest.");
+        }
+        node_pool.blocks[node_pool.block_count] = (forest_node*)allocate_memory((FOREST_POOL_INIT << node_pool.block_count) * sizeof(forest_node));
+        node_pool.block_count++;
+        node_pool.block_used = 0;
+    }
+    return &node_pool.blocks[node_pool.block_count - 1][node_pool.block_used++];
+}
+
 
 forest_node *forest_insert_global() {
-    forest_node *root = (forest_node*)allocate_memory(sizeof(forest_node));
+    forest_node *root = forest_new_node();
     root->name = "global";
     root->keyword = W_GLOBAL;
     root->parent = NULL;
     root->children = NULL;
     root->children_count = 0;
+    root->children_capacity = 0;
+    root->functions = NULL;
+    root->functions_capacity = 0;
+    root->functions_count = 0;
     root->symtable = NULL;
     root->cond_cnt = 0;
     root->param_cnt = 0;
+    root->params = NULL;
+    root->params_capacity = 0;
     root->node_cnt = 0;
     root->has_return = false;
     root->frame = 'G';
     return root; 
 }
 
+// Slot of the function, or the empty slot where it belongs
+static forest_function_slot *forest_function_probe(forest_node *global, const char *key, unsigned int hash) {
+    unsigned int i = hash & (global->functions_capacity - 1);
+    while (global->functions[i].key != NULL && global->functions[i].key != key) {
+        i = (i + 1) & (global->functions_capacity - 1);
+    }
+    return &global->functions[i];
+}
+
+// Built-in functions and the functions defined by func_def() are indexed by their names as they are inserted
+static void forest_register_function(forest_node *global, forest_node *function) {
+    if (2 * (global->functions_count + 1) > global->functions_capacity) {
+        forest_function_slot *old = global->functions;
+        int old_capacity = global->functions_capacity;
+
+        global->functions_capacity = old_capacity == 0 ? FOREST_FUNCTIONS_INIT : 2 * old_capacity;
+        global->functions = (forest_function_slot*)allocate_memory(global->functions_capacity * sizeof(forest_function_slot));
+        memset(global->functions, 0, global->functions_capacity * sizeof(forest_function_slot));
+        for (int i = 0; i < old_capacity; i++) {
+            if (old[i].key != NULL) {
+                *forest_function_probe(global, old[i].key, old[i].hash) = old[i];
+            }
+        }
+        free(old);
+    }
+
+    unsigned int hash = intern_hash(function->name);
+    forest_function_slot *slot = forest_function_probe(global, function->name, hash);
+    // The first function of the name is found, as the search through the children found it
+    if (slot->key == NULL) {
+        slot->key = function->name;
+        slot->hash = hash;
+        slot->function = function;
+        global->functions_count++;
+    }
+}
+
 void forest_insert(forest_node *parent, f_keyword_t keyword, char *name, forest_node **active) {
     if (parent != NULL) {
-        forest_node *child = (forest_node*)allocate_memory(sizeof(forest_node));
+        forest_node *child = forest_new_node();
         child->name = name;
         child->keyword = keyword;
         child->parent = parent;
         child->children = NULL;
         child->children_count = 0;
+        child->children_capacity = 0;
+        child->functions = NULL;
+        child->functions_capacity = 0;
+        child->functions_count = 0;
         child->cond_cnt = 0;
         child->param_cnt = 0;
+        child->params = NULL;
+        child->params_capacity = 0;
         child->node_cnt = ++forest_node_cnt;
         child->has_return = false;
 
-        if (parent->children == NULL) {
-            parent->children = (forest_node**)allocate_memory((sizeof(forest_node*)));
-        } else {
-            // Resize the existing array to accommodate the new child
-            parent->children = (forest_node**)realloc(parent->children, (parent->children_count + 1) * sizeof(forest_node*));
-            if (parent->children == NULL) {
-                error_exit(ERROR_INTERNAL, "REALLOC", "Memory reallocation for forest node children failed");
-            }
+        if (parent->children_count == parent->children_capacity) {
+            // The array grows geometrically, a scope with many children is not copied on every insert
+            parent->children_capacity = parent->children_capacity == 0 ? FOREST_CHILDREN_INIT : 2 * parent->children_capacity;
+            parent->children = (forest_node**)reallocate_memory(parent->children, parent->children_capacity * sizeof(forest_node*));
         }
         parent->children[parent->children_count] = child;
         parent->children_count++;
+        if (keyword == W_FUNCTION && parent->keyword == W_GLOBAL) {
+            forest_register_function(parent, child);
+        }
         child->symtable = NULL;
         *active = child;
 
@@ -79,15 +182,93 @@ void forest_insert(forest_node *parent, f_keyword_t keyword, char *name, forest_
     }
 }
 
-forest_node* forest_search_function(forest_node *global, char *key) {
-    if (global->children != NULL) {
-        for (int i = 0; i < global->children_count; i++) {
-            if (global->children[i]->keyword == W_FUNCTION && strcmp(global->children[i]->name, key) == 0) {
-                return global->children[i];
-            }
+void forest_add_param(forest_node *func, char *id, sym_data *data) {
+    if (func->param_cnt == func->params_capacity) {
+        func->params_capacity = func->params_capacity == 0 ? 4 : 2 * func->params_capacity;
+        func->params = (forest_param*)reallocate_memory(func->params, func->params_capacity * sizeof(forest_param));
+    }
+    func->params[func->param_cnt].id = id;
+    func->params[func->param_cnt].label = data->param_name;
+    func->params[func->param_cnt].type = data->param_type;
+    func->param_cnt++;
+}
+
+
+// Slot of the name, or the empty slot where it belongs, the hash was computed once when the name was interned
+static forest_index_slot *forest_index_probe(const char *key, unsigned int hash) {
+    unsigned int i = hash & (scope_index.capacity - 1);
+    while (scope_index.slots[i].key != NULL && scope_index.slots[i].key != key) {
+        i = (i + 1) & (scope_index.capacity - 1);
+    }
+    return &scope_index.slots[i];
+}
+
+// Double the number of slots when the index gets half full
+static void forest_index_grow() {
+    forest_index_slot *old = scope_index.slots;
+    int old_capacity = scope_index.capacity;
+
+    scope_index.capacity = old_capacity == 0 ? FOREST_INDEX_INIT : 2 * old_capacity;
+    scope_index.slots = (forest_index_slot*)allocate_memory(scope_index.capacity * sizeof(forest_index_slot));
+    memset(scope_index.slots, 0, scope_index.capacity * sizeof(forest_index_slot));
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].key != NULL) {
+            *forest_index_probe(old[i].key, old[i].hash) = old[i];
         }
     }
-    return NULL;
+    free(old);
+}
+
+// Binding of the name in the innermost scope, NULL if the name is not visible
+static forest_binding *forest_index_search(const char *key) {
+    if (scope_index.capacity == 0 || key == NULL) {
+        return NULL;
+    }
+    forest_index_slot *slot = forest_index_probe(key, intern_hash(key));
+    return slot->key != NULL && slot->top >= 0 ? &scope_index.bindings[slot->top] : NULL;
+}
+
+void forest_insert_symbol(forest_node *node, char *key, sym_data *data) {
+    symtable_insert(&node->symtable, key, data);
+
+    if (2 * (scope_index.count + 1) > scope_index.capacity) {
+        forest_index_grow();
+    }
+    unsigned int hash = intern_hash(key);
+    forest_index_slot *slot = forest_index_probe(key, hash);
+    if (slot->key == NULL) {
+        slot->key = key;
+        slot->hash = hash;
+        slot->top = -1;
+        scope_index.count++;
+    }
+
+    if (scope_index.bindings_count == scope_index.bindings_capacity) {
+        scope_index.bindings_capacity = scope_index.bindings_capacity == 0 ? FOREST_INDEX_INIT : 2 * scope_index.bindings_capacity;
+        scope_index.bindings = (forest_binding*)reallocate_memory(scope_index.bindings, scope_index.bindings_capacity * sizeof(forest_binding));
+    }
+    forest_binding *binding = &scope_index.bindings[scope_index.bindings_count];
+    binding->scope = node;
+    binding->symbol = symtable_search(node->symtable, key);
+    binding->shadowed = slot->top;
+    slot->top = scope_index.bindings_count++;
+}
+
+void forest_leave(forest_node **active) {
+    // Symbols are inserted into the active node only, so the bindings of its scope are on top
+    while (scope_index.bindings_count > 0 && scope_index.bindings[scope_index.bindings_count - 1].scope == *active) {
+        forest_binding *binding = &scope_index.bindings[--scope_index.bindings_count];
+        forest_index_probe(binding->symbol->key, intern_hash(binding->symbol->key))->top = binding->shadowed;
+    }
+    *active = (*active)->parent;
+}
+
+
+forest_node* forest_search_function(forest_node *global, char *key) {
+    if (global->functions == NULL || key == NULL) {
+        return NULL;
+    }
+    return forest_function_probe(global, key, intern_hash(key))->function;
 }
 
 
@@ -107,46 +288,15 @@ bool forest_check_inside_func(forest_node *node) {
 }
 
 
-// search for the outermost while loop (codegen problem)
-forest_node* forest_search_while(forest_node *node) {
-    forest_node *while_node = NULL;
-    while (node->parent != NULL) {
-        if (node->keyword == W_WHILE) {
-            while_node = node;
-        }
-        node = node->parent;
-    }
-
-    return while_node;
-}
-
-
-// search for a symbol in a symtable, if not found, search in the parent's symtable
-AVL_tree *forest_search_symbol(forest_node *node, char *key) {
-    if (node != NULL) {
-        if (node->symtable != NULL) {
-            AVL_tree *found = symtable_search(node->symtable, key);
-            if (found != NULL) {
-                return found;
-            }
-        }
-        return forest_search_symbol(node->parent, key);
-    }
-    return NULL;
+// The index has the symbols of the active node and of its parents only
+AVL_tree *forest_search_symbol(char *key) {
+    forest_binding *binding = forest_index_search(key);
+    return binding != NULL ? binding->symbol : NULL;
 }
 
-
-forest_node *forest_search_scope(forest_node *node, char *key) {
-    if (node != NULL) {
-        if (node->symtable != NULL) {
-            AVL_tree *found = symtable_search(node->symtable, key);
-            if (found != NULL) {
-                return node;
-            }
-        }
-        return forest_search_scope(node->parent, key);
-    }
-    return NULL;
+forest_node *forest_search_scope(char *key) {
+    forest_binding *binding = forest_index_search(key);
+    return binding != NULL ? binding->scope : NULL;
 }
 
 
@@ -162,7 +312,21 @@ void forest_dispose(forest_node *global) {
         if (global->symtable != NULL) {
             symtable_dispose(&(global->symtable));
         }
-        free(global);
-        global = NULL;
+        free(global->params);
+        free(global->functions);
+        // The index and the pool live as long as the whole forest
+        if (global->parent == NULL) {
+            free(scope_index.slots);
+            free(scope_index.bindings);
+            memset(&scope_index, 0, sizeof(scope_index));
+            for (int b = 0; b < node_pool.block_count; b++) {
+                free(node_pool.blocks[b]);
+            }
+            memset(&node_pool, 0, sizeof(node_pool));
+        }
+        else {
+            global->parent = node_pool.free;
+            node_pool.free = global;
+        }
     }
 }
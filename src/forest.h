@@ -14,6 +14,11 @@
 
 #include "symtable.h"
 
+#define FOREST_INDEX_INIT 64 // initial number of slots of the index of the visible symbols
+#define FOREST_POOL_INIT 64 // number of nodes in the first block of the pool, every next block is twice as big
+#define FOREST_POOL_BLOCKS 26 // maximal number of blocks of the pool
+#define FOREST_CHILDREN_INIT 4 // initial capacity of the children array, it is doubled when full
+#define FOREST_FUNCTIONS_INIT 32 // initial number of slots of the function index of the global node
 
 // Keyword of the node
 typedef enum f_keyword {
@@ -26,6 +31,20 @@ typedef enum f_keyword {
     W_NONE
 } f_keyword_t;
 
+// Parameter of the function, in the order of the function header
+typedef struct s_forest_param {
+    char *id; // interned identifier used in the body of the function
+    char *label; // interned name used in the calls, '_' if unnamed
+    data_type type;
+} forest_param;
+
+// Slot of the function index of the global node
+typedef struct s_forest_function_slot {
+    char *key; // interned name of the function, NULL if the slot is empty
+    unsigned int hash;
+    struct s_forest_node *function;
+} forest_function_slot;
+
 // Structure of the forest node
 typedef struct s_forest_node {
     f_keyword_t keyword; // type of the node
@@ -33,9 +52,15 @@ typedef struct s_forest_node {
     struct s_forest_node *parent;
     struct s_forest_node **children; // array of pointers to children nodes
     int children_count; // number of children (last index + 1)
-    AVL_tree *symtable; // pointer to the scope's symbol table
+    int children_capacity; // allocated size of the children array
+    forest_function_slot *functions; // index of the function children by name, global node only
+    int functions_capacity;
+    int functions_count;
+    symtable_t *symtable; // pointer to the scope's symbol table
     int cond_cnt; // counter for if/else
     int param_cnt; // counter for parameters
+    forest_param *params; // parameters of the function, NULL for other nodes
+    int params_capacity;
     int node_cnt; // counter for nodes, used for renaming
     bool has_return; // true if the scope has return statement in it
     char frame; // frame of the scope (G/L)
@@ -63,10 +88,38 @@ void forest_insert(forest_node *parent, f_keyword_t keyword, char *name, forest_
 
 
 /**
- * @brief Search the function in the global scope
+ * @brief Appends the parameter to the function's parameters and counts it
+ * 
+ * @param func Pointer to the function node
+ * @param id Interned identifier of the parameter, its key in the function's symtable
+ * @param data Data of the parameter in the function's symtable, its name and type are copied
+ */
+void forest_add_param(forest_node *func, char *id, sym_data *data);
+
+
+/**
+ * @brief Inserts the symbol into the symtable of the active node and makes it visible until the node is left
+ * 
+ * @param node Pointer to the active node
+ * @param key Interned key of the symbol
+ * @param data Data of the symbol
+ */
+void forest_insert_symbol(forest_node *node, char *key, sym_data *data);
+
+
+/**
+ * @brief Leaves the active node, its symbols are not visible anymore and the parent becomes active
+ * 
+ * @param active Pointer to the active node in forest
+ */
+void forest_leave(forest_node **active);
+
+
+/**
+ * @brief Search the function in the global scope, the function index of the global node is used
  * 
  * @param global Pointer to the global node (root of the forest)
- * @param key Key of the function to search for
+ * @param key Interned key of the function to search for
  * @return forest_node* Pointer to the function if found, NULL otherwise
  */
 forest_node* forest_search_function(forest_node *global, char *key);
@@ -83,32 +136,21 @@ bool forest_check_inside_func(forest_node *node);
 
 
 /**
- * @brief Search for the outermost while loop (codegen problem)
- * 
- * @param node Pointer to the node where to start searching
- * @return forest_node* Pointer to the outermost while loop
- */
-forest_node* forest_search_while(forest_node *node);
-
-
-/**
- * @brief Searches for a symbol in the symbol table of the node (and its parents if not found)
+ * @brief Searches for a symbol visible in the active node, the innermost scope having it wins
  * 
- * @param node Pointer to the node where to start searching
- * @param key Key of the symbol to search for
+ * @param key Interned key of the symbol to search for
  * @return AVL_tree* Pointer to the symbol if found, NULL otherwise
  */
-AVL_tree *forest_search_symbol(forest_node *node, char *key);
+AVL_tree *forest_search_symbol(char *key);
 
 
 /**
- * @brief Searches for a scope where the symbol is (and its parents if not found)
+ * @brief Searches for the innermost scope of the active node where the symbol is
  * 
- * @param node Pointer to the node where to start searching
- * @param key Key of the symbol to search for
+ * @param key Interned key of the symbol to search for
  * @return forest_node* Pointer to the scope if found, NULL otherwise
  */
-forest_node *forest_search_scope(forest_node *node, char *key);
+forest_node *forest_search_scope(char *key);
 
 
 /**
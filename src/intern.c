@@ -0,0 +1,132 @@
+/**
+ * @file intern.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Interning pool of identifiers shared by scanner, symtable and codegen
+ *
+ * @author Marek Effenberger <xeffen00>
+ */
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <string.h>
+
+static intern_pool_t pool = {NULL, 0, 0, NULL}; // the only pool of the compiler, reached through the intern_* functions only
+
+
+// FNV-1a hash of the string
+static unsigned int intern_compute_hash(const char *str, int length) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Allocate space for the entry from the current chunk, new chunk is allocated if there is no space left
+static intern_entry_t *intern_alloc_entry(int length) {
+    // Keep the entries aligned for the header
+    size_t size = (sizeof(intern_entry_t) + length + 1 + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+    if (pool.chunks == NULL || pool.chunks->used + size > pool.chunks->size) {
+        size_t chunk_size = size > INTERN_CHUNK_SIZE ? size : INTERN_CHUNK_SIZE;
+        intern_chunk_t *chunk = (intern_chunk_t*)allocate_memory(sizeof(intern_chunk_t) + chunk_size);
+        chunk->next = pool.chunks;
+        chunk->used = 0;
+        chunk->size = chunk_size;
+        pool.chunks = chunk;
+    }
+
+    intern_entry_t *entry = (intern_entry_t*)(pool.chunks->data + pool.chunks->used);
+    pool.chunks->used += size;
+    return entry;
+}
+
+// Double the size of the table and rehash all entries using their stored hashes
+static void intern_grow() {
+    int new_capacity = pool.capacity == 0 ? INTERN_TABLE_SIZE : pool.capacity * 2;
+    intern_entry_t **new_slots = (intern_entry_t**)allocate_memory(sizeof(intern_entry_t*) * new_capacity);
+    memset(new_slots, 0, sizeof(intern_entry_t*) * new_capacity);
+
+    for (int i = 0; i < pool.capacity; i++) {
+        if (pool.slots[i] != NULL) {
+            unsigned int index = pool.slots[i]->hash & (new_capacity - 1);
+            while (new_slots[index] != NULL) {
+                index = (index + 1) & (new_capacity - 1);
+            }
+            new_slots[index] = pool.slots[i];
+        }
+    }
+
+    free(pool.slots);
+    pool.slots = new_slots;
+    pool.capacity = new_capacity;
+}
+
+char *intern(const char *str, int length) {
+    // Keep the load factor under 1/2
+    if ((pool.count + 1) * 2 > pool.capacity) {
+        intern_grow();
+    }
+
+    unsigned int hash = intern_compute_hash(str, length);
+    unsigned int index = hash & (pool.capacity - 1);
+
+    while (pool.slots[index] != NULL) {
+        intern_entry_t *entry = pool.slots[index];
+        if (entry->hash == hash && entry->length == length && memcmp(entry->name, str, length) == 0) {
+            return entry->name;
+        }
+        index = (index + 1) & (pool.capacity - 1);
+    }
+
+    // String seen for the first time, store its copy
+    intern_entry_t *entry = intern_alloc_entry(length);
+    entry->hash = hash;
+    entry->length = length;
+    memcpy(entry->name, str, length);
+    entry->name[length] = '\0';
+
+    pool.slots[index] = entry;
+    pool.count++;
+    return entry->name;
+}
+
+char *intern_str(const char *str) {
+    return intern(str, strlen(str));
+}
+
+unsigned int intern_hash(const char *name) {
+    const intern_entry_t *entry = (const intern_entry_t*)(name - offsetof(intern_entry_t, name));
+    return entry->hash;
+}
+
+void intern_dispose() {
+    while (pool.chunks != NULL) {
+        intern_chunk_t *next = pool.chunks->next;
+        free(pool.chunks);
+        pool.chunks = next;
+    }
+    free(pool.slots);
+    pool.slots = NULL;
+    pool.capacity = 0;
+    pool.count = 0;
+}
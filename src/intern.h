@@ -0,0 +1,78 @@
+/**
+ * @file intern.h
+ *
+ * IFJ23 compiler
+ *
+ * @brief Interning pool of identifiers shared by scanner, symtable and codegen
+ *
+ * @author Marek Effenberger <xeffen00>
+ */
+
+#ifndef IFJ_INTERN_H
+#define IFJ_INTERN_H
+
+#include <stddef.h>
+
+#define INTERN_TABLE_SIZE 1024 // default number of slots in the hash table, always a power of two
+#define INTERN_CHUNK_SIZE 16384 // size of one chunk of memory holding the interned strings
+
+// Interned string, the handle of the string is the pointer to its name
+typedef struct intern_entry {
+    unsigned int hash;
+    int length;
+    char name[]; // null terminated copy of the string
+} intern_entry_t;
+
+// Chunk of memory the entries are allocated from
+typedef struct intern_chunk {
+    struct intern_chunk *next;
+    size_t used;
+    size_t size;
+    char data[];
+} intern_chunk_t;
+
+// Hash table of all interned strings (open addressing with linear probing)
+typedef struct intern_pool {
+    intern_entry_t **slots;
+    int capacity;
+    int count;
+    intern_chunk_t *chunks;
+} intern_pool_t;
+
+
+/**
+ * @brief Intern the string of given length
+ *
+ * @note Equal strings are always interned to the same pointer, names can then be compared by ==
+ * @param str String to be interned, it does not have to be null terminated
+ * @param length Length of the string
+ * @return char* Stable null terminated handle of the string, valid until intern_dispose
+ */
+char *intern(const char *str, int length);
+
+
+/**
+ * @brief Intern the null terminated string
+ *
+ * @param str String to be interned
+ * @return char* Stable null terminated handle of the string
+ */
+char *intern_str(const char *str);
+
+
+/**
+ * @brief Get the hash of the interned string without computing it again
+ *
+ * @param name Handle returned by intern
+ * @return unsigned int Hash of the string
+ */
+unsigned int intern_hash(const char *name);
+
+
+/**
+ * @brief Release all interned strings
+ */
+void intern_dispose();
+
+
+#endif //IFJ_INTERN_H
@@ -14,17 +14,51 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
+#include <stdlib.h>
+#include <string.h>
 
+#define LEX_THREADS_OPTION "--lex-threads="
+#define PIPELINE_OPTION "--pipeline"
+#define STREAM_OPTION "--stream"
+
+
+int main(int argc, char **argv) {
+    // --lex-threads=N scans large source codes on N threads before parsing
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], LEX_THREADS_OPTION, strlen(LEX_THREADS_OPTION)) == 0) {
+            parallel_lex_threads = atoi(argv[i] + strlen(LEX_THREADS_OPTION));
+            if (parallel_lex_threads < 1) {
+                parallel_lex_threads = 1;
+            }
+        }
+        // --pipeline scans the source code on own thread which feeds the parser, with --stream the code is generated on another one
+        else if (strcmp(argv[i], PIPELINE_OPTION) == 0) {
+            token_pipe_enabled = true;
+            codegen_pipe_enabled = true;
+        }
+        // --stream generates the code after each top-level statement or function definition and frees it
+        else if (strcmp(argv[i], STREAM_OPTION) == 0) {
+            codegen_stream_enabled = true;
+        }
+        else {
+            error_exit(ERROR_INTERNAL, "MAIN", "Unknown option");
+        }
+    }
 
-int main() {
     return parser_parse_please();
 }
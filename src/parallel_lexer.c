@@ -0,0 +1,199 @@
+/**
+ * @file parallel_lexer.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Speculative lexing of large source codes on several threads
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+int parallel_lex_threads = 1;
+
+/// Part of the source code scanned by one thread
+typedef struct lex_chunk {
+    const source_t* code; //source code loaded by the thread which started the lexing
+    const char* begin;
+    const char* end; //first position behind the chunk, just behind EOL
+    token_stream_t normal; //tokens scanned as if the chunk started in normal code
+    token_stream_t inside; //tokens scanned as if the chunk started inside of multiline string or nested comment
+    token_arena_t arena; //strings of the tokens, detached from the thread
+    pthread_t thread;
+} lex_chunk_t;
+
+//Returns position behind the first "*/" or "\"\"\"" in the chunk, NULL if there is none
+static const char* find_closing(const char* p, const char* end){
+    for(; p + 1 < end; p++){
+        if(p[0] == '*' && p[1] == '/'){
+            return p + 2;
+        }
+        if(p + 2 < end && p[0] == '"' && p[1] == '"' && p[2] == '"'){
+            return p + 3;
+        }
+    }
+    return NULL;
+}
+
+static void* lex_chunk(void* arg){
+    lex_chunk_t* chunk = (lex_chunk_t*) arg;
+
+    scan_range(&chunk->normal, chunk->code, chunk->begin, chunk->end);
+    //The first chunk starts in normal code for sure
+    const char* resume = chunk->begin == chunk->code->data ? NULL : find_closing(chunk->begin, chunk->end);
+    if(resume != NULL){
+        scan_range(&chunk->inside, chunk->code, resume, chunk->end);
+    }
+
+    scanner_thread_dispose();
+    chunk->arena = token_arena_detach();
+    return NULL;
+}
+
+//Finds the token the scanning of which started at position, tokens of the stream are ordered by it
+static bool stream_find(const token_stream_t* stream, const char* position, size_t* index){
+    size_t low = 0, high = stream->count;
+    while(low < high){
+        size_t middle = low + (high - low) / 2;
+        if(stream->starts[middle] < position){
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    *index = low;
+    return low < stream->count && stream->starts[low] == position;
+}
+
+static void stream_dispose(token_stream_t* stream){
+    free(stream->tokens);
+    free(stream->starts);
+    memset(stream, 0, sizeof(token_stream_t));
+}
+
+void parallel_lex(){
+    //Chunks need the source code loaded by this thread, the threads share it read only
+    const source_t* code = &source;
+    size_t size = code->end - code->data;
+    size_t count = size / PARALLEL_LEX_MIN_CHUNK;
+    if(count > (size_t) parallel_lex_threads){
+        count = parallel_lex_threads;
+    }
+    if(count > PARALLEL_LEX_MAX_THREADS){
+        count = PARALLEL_LEX_MAX_THREADS;
+    }
+    if(count < 2){
+        return;
+    }
+
+    lex_chunk_t* chunks = (lex_chunk_t*) allocate_memory(count * sizeof(lex_chunk_t));
+    memset(chunks, 0, count * sizeof(lex_chunk_t));
+
+    //Chunks end just behind EOL, no token but string or comment can cross their boundary then
+    const char* begin = code->data;
+    for(size_t i = 0; i < count; i++){
+        const char* end = code->end;
+        if(i + 1 < count){
+            const char* split = code->data + size / count * (i + 1);
+            if(split < begin){
+                split = begin;
+            }
+            const char* eol = memchr(split, '\n', code->end - split);
+            end = eol != NULL ? eol + 1 : code->end;
+        }
+        chunks[i].code = code;
+        chunks[i].begin = begin;
+        chunks[i].end = end;
+        begin = end;
+    }
+
+    for(size_t i = 0; i < count; i++){
+        if(pthread_create(&chunks[i].thread, NULL, lex_chunk, &chunks[i]) != 0){
+            error_exit(ERROR_INTERNAL, "SCANNER", "Lexing thread cannot be created");
+        }
+    }
+    for(size_t i = 0; i < count; i++){
+        pthread_join(chunks[i].thread, NULL);
+        token_arena_adopt(&chunks[i].arena);
+    }
+
+    //Stitching, position is where the real scanning of the next token starts
+    token_t* tokens = NULL;
+    size_t length = 0;
+    size_t capacity = 0;
+    const char* position = code->data;
+    bool stop = false;
+
+    for(size_t i = 0; i < count && !stop; i++){
+        token_stream_t* guesses[2] = {&chunks[i].normal, &chunks[i].inside};
+        token_stream_t rescan = {0};
+        token_stream_t* stream = NULL;
+        size_t first = 0;
+
+        for(int g = 0; g < 2 && stream == NULL; g++){
+            if(stream_find(guesses[g], position, &first)){
+                stream = guesses[g];
+            }
+        }
+        //Neither guess met the real scanning, the rest of the chunk is scanned again
+        if(stream == NULL){
+            scan_range(&rescan, code, position, chunks[i].end);
+            stream = &rescan;
+            first = 0;
+        }
+
+        if(length + stream->count - first > capacity){
+            capacity = 2 * (length + stream->count - first);
+            tokens = (token_t*) reallocate_memory(tokens, capacity * sizeof(token_t));
+        }
+        for(size_t t = first; t < stream->count; t++){
+            token_t* token = &tokens[length++];
+            *token = stream->tokens[t];
+            //Names are interned here so that the pool is used by one thread only
+            if(token->type == TOKEN_ID || token->type == TOKEN_KEYWORD || token->type == TOKEN_KEYWORD_QM || token->type == TOKEN_UNDERSCORE){
+                token->value.name = intern(token->value.lexeme, token->value.length);
+            }
+            if(token->type == TOKEN_EOF){
+                stop = true;
+            }
+        }
+        position = stream->exit;
+        //Tokens in front of the lexical error are real, the error is reported when the parser gets to it
+        if(stream->failed){
+            stop = true;
+        }
+        stream_dispose(&rescan);
+    }
+
+    for(size_t i = 0; i < count; i++){
+        stream_dispose(&chunks[i].normal);
+        stream_dispose(&chunks[i].inside);
+    }
+    free(chunks);
+
+    scanner_use_tokens(tokens, length, position);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file parallel_lexer.h
+ *
+ * IFJ23 compiler
+ *
+ * @brief Speculative lexing of large source codes on several threads
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#ifndef IFJ_PARALLEL_LEXER_H
+#define IFJ_PARALLEL_LEXER_H
+
+#ifndef PARALLEL_LEX_MIN_CHUNK
+#define PARALLEL_LEX_MIN_CHUNK (256 * 1024) // smallest part of the source code worth its own thread
+#endif
+
+#define PARALLEL_LEX_MAX_THREADS 64 // upper bound of the number of lexing threads
+
+extern int parallel_lex_threads; // number of threads lexing the source code, 1 scans it sequentially with the parser
+
+/**
+ * @brief Scan the whole source code loaded by source_init on several threads
+ *
+ * The source code is split into chunks at EOLs. Every chunk is scanned twice as if it started
+ * in normal code and as if it started inside of multiline string or nested comment. The chunks
+ * are then stitched together in order, the scanning of chunk is repeated only if neither guess
+ * meets the real end of the previous chunk. get_me_token hands out the tokens afterwards.
+ *
+ * @note Nothing is done for small source codes or when parallel_lex_threads is 1
+ */
+void parallel_lex();
+
+#endif //IFJ_PARALLEL_LEXER_H
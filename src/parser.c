@@ -12,20 +12,26 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 #include <string.h>
 
 forest_node *active = NULL; // Pointer to the active node in the forest
 token_t *current_token = NULL; // Pointer to the current token
-token_t *token_buffer = NULL; // Buffer for tokens
+queue_t *lookahead = NULL; // Window of tokens read from the scanner ahead of the parser
 queue_t *queue = NULL; // Queue for the expression parser
 instruction_list *inst_list = NULL; // List of instructions for codegen
 cnt_stack_t *cnt_stack = NULL; // Stack for appropriate counting of if-else statements
@@ -45,6 +51,9 @@ bool vardef_assign = false; // For assign() to know where to get info about the
 bool function_write = false; // For parser to know that the function being handled is write() and needs special treatment
 bool return_expr = false; // For expression parser to know that the expression is in return statement
 builtin_defs *built_in_defs = NULL; // Flags for defining built-in functions in codegen, so they are not defined multiple times
+int streamed_children = AFTER_BUILTIN; // Children of the global scope already generated in streaming mode, all of them are functions
+callee_list_t **unchecked_callee = &callee_list_first; // Link to the first function call not validated in streaming mode yet
+int outermost_while_anchor = INST_NONE; // Index of the WHILE_START of the open outermost while, definitions in the loop are inserted before it
 extern FILE *file;
 
 
@@ -85,10 +94,10 @@ data_type convert_dt(token_t* token) {
     }
 }
 
-// Needed in decision procedure to rightfully determine the next path in recursive descent parser
-void peek() {
+// Function which loads in the next token from scanner, EOLs are only remembered in the following token
+static token_t *scan_token() {
     token_t *token = get_me_token();
-    
+
     // Mechanism for detecting EOLs
     bool eol = false;
     while (token->type == TOKEN_EOL) {
@@ -99,116 +108,109 @@ void peek() {
         token->prev_was_eol = true;
     }
 
-    token_buffer = token;
+    return token;
 }
 
-// Function which loads in the next token from scanner
-token_t* get_next_token() {
-    if (token_buffer == NULL) {
-
-        token_t *token = get_me_token();
-
-        // Mechanism for detecting EOLs
-        bool eol = false;
-        while (token->type == TOKEN_EOL) {
-            token = get_me_token();
-            eol = true;
-        }
-        if (eol) {
-            token->prev_was_eol = true;
-        }
+// Needed in decision procedure to rightfully determine the next path in recursive descent parser
+token_t *peek(unsigned k) {
+    while (lookahead->count <= k) {
+        queue_push(lookahead, scan_token());
+    }
+    return queue_at(lookahead, k);
+}
 
-        return token;
-    } 
-    else {
-        token_t* tmp = token_buffer;
-        token_buffer = NULL;
-        return tmp;
+// Function which returns the next token, from the lookahead window if it was already read
+token_t* get_next_token() {
+    if (lookahead->count == 0) {
+        return scan_token();
     }
+    return queue_pop(lookahead);
 }
 
 // Function Called in the beginning, at all times the built-ins are recognized by the inner representation
 void insert_built_in_functions_into_forest() {
     // func readString() -> String?
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "readString");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("readString"));
     sym_data *readString = set_data_func(STRING_QM);
-    symtable_insert(&active->symtable, "readString", readString);
+    forest_insert_symbol(active, intern_str("readString"), readString);
     BACK_TO_PARENT_IN_FOREST;
 
     // func readInt() -> Int?
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "readInt");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("readInt"));
     sym_data *readInt = set_data_func(INT_QM);
-    symtable_insert(&active->symtable, "readInt", readInt);
+    forest_insert_symbol(active, intern_str("readInt"), readInt);
     BACK_TO_PARENT_IN_FOREST;
 
     // func readDouble() -> Double?
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "readDouble");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("readDouble"));
     sym_data *readDouble = set_data_func(DOUBLE_QM);
-    symtable_insert(&active->symtable, "readDouble", readDouble);
+    forest_insert_symbol(active, intern_str("readDouble"), readDouble);
     BACK_TO_PARENT_IN_FOREST;
 
     // func write(term_1, term_2, ..., term_n)
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "write");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("write"));
     sym_data *write = set_data_func(VOID);
-    symtable_insert(&active->symtable, "write", write);
+    forest_insert_symbol(active, intern_str("write"), write);
     BACK_TO_PARENT_IN_FOREST;
 
     // func Int2Double(_ term : Int) -> Double
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "Int2Double");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("Int2Double"));
     sym_data *Int2Double = set_data_func(DOUBLE);
-    symtable_insert(&active->symtable, "Int2Double", Int2Double);
-    sym_data *Int2Double_param_data = set_data_param(INT, "_", 1);
-    symtable_insert(&active->symtable, "term", Int2Double_param_data);
-    active->param_cnt = 1;
+    forest_insert_symbol(active, intern_str("Int2Double"), Int2Double);
+    sym_data *Int2Double_param_data = set_data_param(INT, intern_str("_"), 1);
+    forest_insert_symbol(active, intern_str("term"), Int2Double_param_data);
+    forest_add_param(active, intern_str("term"), Int2Double_param_data);
     BACK_TO_PARENT_IN_FOREST;
 
     // func Double2Int(_ term : Double) -> Int
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "Double2Int");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("Double2Int"));
     sym_data *Double2Int = set_data_func(INT);
-    symtable_insert(&active->symtable, "Double2Int", Double2Int);
-    sym_data *Double2Int_param_data = set_data_param(DOUBLE, "_", 1);
-    symtable_insert(&active->symtable, "term", Double2Int_param_data);
-    active->param_cnt = 1;
+    forest_insert_symbol(active, intern_str("Double2Int"), Double2Int);
+    sym_data *Double2Int_param_data = set_data_param(DOUBLE, intern_str("_"), 1);
+    forest_insert_symbol(active, intern_str("term"), Double2Int_param_data);
+    forest_add_param(active, intern_str("term"), Double2Int_param_data);
     BACK_TO_PARENT_IN_FOREST;
 
     // func length(_ s : String) -> Int
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "length");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("length"));
     sym_data *length = set_data_func(INT);
-    symtable_insert(&active->symtable, "length", length);
-    sym_data *length_param_data = set_data_param(STRING, "_", 1);
-    symtable_insert(&active->symtable, "s", length_param_data);
-    active->param_cnt = 1;
+    forest_insert_symbol(active, intern_str("length"), length);
+    sym_data *length_param_data = set_data_param(STRING, intern_str("_"), 1);
+    forest_insert_symbol(active, intern_str("s"), length_param_data);
+    forest_add_param(active, intern_str("s"), length_param_data);
     BACK_TO_PARENT_IN_FOREST;
 
     // func substring(of s : String, startingAt i : Int, endingBefore j : Int) -> String?
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "substring");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("substring"));
     sym_data *substring = set_data_func(STRING_QM);
-    symtable_insert(&active->symtable, "substring", substring);
-    sym_data *substring_param_data1 = set_data_param(STRING, "of", 1);
-    symtable_insert(&active->symtable, "s", substring_param_data1);
-    sym_data *substring_param_data2 = set_data_param(INT, "startingAt", 2);
-    symtable_insert(&active->symtable, "i", substring_param_data2);
-    sym_data *substring_param_data3 = set_data_param(INT, "endingBefore", 3);
-    symtable_insert(&active->symtable, "j", substring_param_data3);
-    active->param_cnt = 3;
+    forest_insert_symbol(active, intern_str("substring"), substring);
+    sym_data *substring_param_data1 = set_data_param(STRING, intern_str("of"), 1);
+    forest_insert_symbol(active, intern_str("s"), substring_param_data1);
+    forest_add_param(active, intern_str("s"), substring_param_data1);
+    sym_data *substring_param_data2 = set_data_param(INT, intern_str("startingAt"), 2);
+    forest_insert_symbol(active, intern_str("i"), substring_param_data2);
+    forest_add_param(active, intern_str("i"), substring_param_data2);
+    sym_data *substring_param_data3 = set_data_param(INT, intern_str("endingBefore"), 3);
+    forest_insert_symbol(active, intern_str("j"), substring_param_data3);
+    forest_add_param(active, intern_str("j"), substring_param_data3);
     BACK_TO_PARENT_IN_FOREST;
 
     // func ord(_ c : String) -> Int
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "ord");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("ord"));
     sym_data *ord = set_data_func(INT);
-    symtable_insert(&active->symtable, "ord", ord);
-    sym_data *ord_param_data = set_data_param(STRING, "_", 1);
-    symtable_insert(&active->symtable, "c", ord_param_data);
-    active->param_cnt = 1;
+    forest_insert_symbol(active, intern_str("ord"), ord);
+    sym_data *ord_param_data = set_data_param(STRING, intern_str("_"), 1);
+    forest_insert_symbol(active, intern_str("c"), ord_param_data);
+    forest_add_param(active, intern_str("c"), ord_param_data);
     BACK_TO_PARENT_IN_FOREST;
 
     // func chr(_ i : Int) -> String
-    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, "chr");
+    MAKE_CHILDREN_IN_FOREST(W_FUNCTION, intern_str("chr"));
     sym_data *chr = set_data_func(STRING);
-    symtable_insert(&active->symtable, "chr", chr);
-    sym_data *chr_param_data = set_data_param(INT, "_", 1);
-    symtable_insert(&active->symtable, "i", chr_param_data);
-    active->param_cnt = 1;
+    forest_insert_symbol(active, intern_str("chr"), chr);
+    sym_data *chr_param_data = set_data_param(INT, intern_str("_"), 1);
+    forest_insert_symbol(active, intern_str("i"), chr_param_data);
+    forest_add_param(active, intern_str("i"), chr_param_data);
     BACK_TO_PARENT_IN_FOREST;
 }
 
@@ -220,14 +222,24 @@ void prog() {
     if (current_token->type == TOKEN_EOF) {
         return;
     }
-    else if (current_token->value.keyword == KW_FUNC) {
+
+    // Tokens of the previous function or statement are not referenced anymore, release them in bulk
+    if (queue->count == 0) {
+        token_arena_release(current_token);
+    }
+
+    if (current_token->value.keyword == KW_FUNC) {
         func_def();
-        prog();
     }
     else {
         body();
-        prog();
     }
+
+    // The finished statement or function definition does not depend on anything after it
+    if (codegen_stream_enabled) {
+        stream_generated_code(active);
+    }
+    prog();
 }
 
 // Defining a function
@@ -239,18 +251,18 @@ void func_def() {
     if (current_token->type == TOKEN_ID) {
 
         // Check if the function is already defined
-        forest_node *func_check = forest_search_function(active, current_token->value.vector->array);
+        forest_node *func_check = forest_search_function(active, current_token->value.name);
         if (func_check != NULL) {
             error_exit(ERROR_SEM_UNDEF_FUN, "PARSER", "Function is already defined and cannot be redefined");
         }
 
-        AVL_tree *sym_check = symtable_search(active->symtable, current_token->value.vector->array);
+        AVL_tree *sym_check = symtable_search(active->symtable, current_token->value.name);
         if (sym_check != NULL) {
             error_exit(ERROR_SEM_UNDEF_FUN, "PARSER", "Cannot use the same name for function as was used for variable");
         }
 
         // The function is now recognized by the IR of the compiler, it is now set to be active
-        MAKE_CHILDREN_IN_FOREST(W_FUNCTION, current_token->value.vector->array);
+        MAKE_CHILDREN_IN_FOREST(W_FUNCTION, current_token->value.name);
         
         current_token = get_next_token();
 
@@ -259,13 +271,12 @@ void func_def() {
 
             params();
 
-            // Set the number of parameters of the function
-            active->param_cnt = param_order;
+            // The parameters were counted by forest_add_param
             param_order = 0;
 
             // CODEGEN
-            instruction *inst = inst_init(FUNC_DEF, 'G', active->name, active->param_cnt, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(FUNC_DEF, 'G', active->name, active->param_cnt, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
 
             if (current_token->type == TOKEN_RPAR) {
                 current_token = get_next_token();
@@ -273,9 +284,9 @@ void func_def() {
                 ret_type();
 
                 // Insert function with its return type to symtable
-                sym_data *func_data = set_data_func(convert_dt(queue->first->token));
-                symtable_insert(&active->symtable, active->name, func_data);
-                queue_dispose(queue);
+                sym_data *func_data = set_data_func(convert_dt(queue_at(queue, 0)));
+                forest_insert_symbol(active, active->name, func_data);
+                queue_clear(queue);
 
                 if (current_token->type == TOKEN_LEFT_BRACKET) {
                     // Get the next token, body expects first token of body
@@ -293,8 +304,8 @@ void func_def() {
                         current_token = get_next_token();
 
                         // CODEGEN
-                        instruction *inst = inst_init(FUNC_DEF_END, 'G', active->name, 0, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(FUNC_DEF_END, 'G', active->name, 0, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         BACK_TO_PARENT_IN_FOREST;
 
@@ -326,6 +337,10 @@ void local_body() {
     // <local_body> -> <body> <local_body> | eps
 
     while (current_token->type != TOKEN_RIGHT_BRACKET) {
+        // Tokens of the previous statement are not referenced anymore, release them in bulk
+        if (queue->count == 0) {
+            token_arena_release(current_token);
+        }
         body();
     }
 }
@@ -360,15 +375,16 @@ void params() {
     }
 
     // Name of the parameter has to differ from the identifier of the parameter (except for case when the name and id is _)
-    if (strcmp(queue->first->token->value.vector->array, queue->first->next->token->value.vector->array) == 0 && 
-        strcmp(queue->first->token->value.vector->array, "_") != 0) {
+    if (queue_at(queue, 0)->value.name == queue_at(queue, 1)->value.name && 
+        queue_at(queue, 0)->type != TOKEN_UNDERSCORE) {
         error_exit(ERROR_SEM_OTHER, "PARSER", "Parameter's name has to differ from its identifier");
     }
     
     // Insert parameter to function's symtable
-    sym_data *param_data = set_data_param(convert_dt(current_token), queue->first->token->value.vector->array, ++param_order);
-    symtable_insert(&active->symtable, queue->first->next->token->value.vector->array, param_data);
-    queue_dispose(queue);
+    sym_data *param_data = set_data_param(convert_dt(current_token), queue_at(queue, 0)->value.name, ++param_order);
+    forest_insert_symbol(active, queue_at(queue, 1)->value.name, param_data);
+    forest_add_param(active, queue_at(queue, 1)->value.name, param_data);
+    queue_clear(queue);
 
     current_token = get_next_token();
 
@@ -442,8 +458,7 @@ void type() {
 void params_n() {
     // <params_n> -> eps | , <params>
     
-    peek();
-    if (token_buffer->type != TOKEN_ID && token_buffer->type != TOKEN_UNDERSCORE) {
+    if (peek(0)->type != TOKEN_ID && peek(0)->type != TOKEN_UNDERSCORE) {
         error_exit(ERROR_SYN, "PARSER", "Missing name of function's parameter");
     }
     else {
@@ -497,8 +512,8 @@ void ret() {
         current_token = get_next_token();
 
         // CODEGEN
-        instruction *inst = inst_init(FUNC_DEF_RETURN_VOID, 'G', tmp->name, 0, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(FUNC_DEF_RETURN_VOID, 'G', tmp->name, 0, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
 
         return;
     }
@@ -510,8 +525,8 @@ void ret() {
         return_expr = false;
 
         // CODEGEN
-        instruction *inst = inst_init(FUNC_DEF_RETURN, 'G', tmp->name, 0, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(FUNC_DEF_RETURN, 'G', tmp->name, 0, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
     }
 }
 
@@ -524,10 +539,9 @@ void body() {
 
     // Possible assignment to variable
     if (current_token->type == TOKEN_ID) {
-        peek();
-        if (token_buffer->type == TOKEN_EQ) {
-            var_name = current_token->value.vector->array; // for case: id = <exp>
-            AVL_tree *tmp = forest_search_symbol(active, var_name);
+        if (peek(0)->type == TOKEN_EQ) {
+            var_name = current_token->value.name; // for case: id = <exp>
+            AVL_tree *tmp = forest_search_symbol(var_name);
 
             // check if the id is in symtable, so the variable is declared
             if (tmp == NULL) {
@@ -543,7 +557,7 @@ void body() {
             assign();
 
         }
-        else if (token_buffer->type == TOKEN_LPAR) {
+        else if (peek(0)->type == TOKEN_LPAR) {
             // Function call without assigning, expecting void function
             func_call();
             callee_list = callee_list->next;
@@ -579,15 +593,14 @@ void body() {
 
             // Write(term_1, term_2, ..., term_n)
             case KW_WRT:
-                peek();
-                if (token_buffer->type == TOKEN_LPAR) {
+                if (peek(0)->type == TOKEN_LPAR) {
                     function_write = true;
                     func_call();
                     function_write = false;
 
                     // CODEGEN
-                    instruction *inst = inst_init(WRITE, 'G', NULL, callee_list->callee->arg_count, 0, 0.0, NULL);
-                    inst_list_insert_last(inst_list, inst);
+                    instruction inst = inst_init(WRITE, 'G', NULL, callee_list->callee->arg_count, 0, 0.0, NULL);
+                    inst_list_insert_last(inst_list, &inst);
                     callee_list = callee_list->next;
                     break;
                 }
@@ -630,7 +643,7 @@ void var_def() {
     current_token = get_next_token();
 
     if (current_token->type == TOKEN_ID) {
-        var_name = current_token->value.vector->array; // For a case: let/var id = <exp>
+        var_name = current_token->value.name; // For a case: let/var id = <exp>
         
         // A case, where variable is declared with the same name as function already existing
         forest_node *func_check = forest_search_function(active, var_name);
@@ -650,7 +663,7 @@ void var_def() {
         sym_data *var_data = NULL;
 
         // Insert variable to symtable
-        if (queue->first->next == NULL) { // The data type is not specified, expression parser determined it
+        if (queue->count < 2) { // The data type is not specified, expression parser determined it
             if (type_of_expr == NIL) {
                 error_exit(ERROR_SEM_DERIV, "PARSER", "Variable cannot derive its type from nil");
             }
@@ -669,18 +682,18 @@ void var_def() {
         else { // The data type was specified, expression parser will handle it as there is expected data type
             // '= nil' does not go through the expression parses, has to be handled here
             if (type_of_expr == NIL) {
-                if (convert_dt(queue->first->next->token) != INT_QM && 
-                    convert_dt(queue->first->next->token) != DOUBLE_QM && 
-                    convert_dt(queue->first->next->token) != STRING_QM)
+                if (convert_dt(queue_at(queue, 1)) != INT_QM && 
+                    convert_dt(queue_at(queue, 1)) != DOUBLE_QM && 
+                    convert_dt(queue_at(queue, 1)) != STRING_QM)
                 {
                     error_exit(ERROR_SEM_EXPR_TYPE, "PARSER", "Variable cannot be of type nil");
                 }
             }
-            var_data = set_data_var(is_initialized, convert_dt(queue->first->next->token), letvar);
+            var_data = set_data_var(is_initialized, convert_dt(queue_at(queue, 1)), letvar);
         }        
 
-        symtable_insert(&active->symtable, queue->first->token->value.vector->array, var_data);
-        queue_dispose(queue);
+        forest_insert_symbol(active, queue_at(queue, 0)->value.name, var_data);
+        queue_clear(queue);
 
         AVL_tree *symbol = symtable_search(active->symtable, var_name);
         symbol->nickname = active->node_cnt;
@@ -692,19 +705,19 @@ void var_def() {
         if (symbol->data->defined) {
             if (type_of_expr == NIL) {
                 // CODEGEN
-                instruction *inst = inst_init(VAR_ASSIGN_NIL, active->frame, nickname, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(VAR_ASSIGN_NIL, active->frame, nickname, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
             }
             else {
                 // CODEGEN
-                instruction *inst = inst_init(VAR_ASSIGN, active->frame, nickname, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(VAR_ASSIGN, active->frame, nickname, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
             }
         }
         if (!symbol->data->defined && (symbol->data->data_type == INT_QM || symbol->data->data_type == DOUBLE_QM || symbol->data->data_type == STRING_QM)) {
             // CODEGEN
-            instruction *inst = inst_init(IMPLICIT_NIL, active->frame, nickname, 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(IMPLICIT_NIL, active->frame, nickname, 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
         }
 
         return;
@@ -718,8 +731,7 @@ void var_def() {
 void opt_var_def() {
     // <opt_var_def> -> : <type> | <assign> | : <type> <assign>
     
-    peek();    
-    if (token_buffer->type == TOKEN_COLON) {
+    if (peek(0)->type == TOKEN_COLON) {
         
         // Get TOKEN_COLON from buffer
         current_token = get_next_token();
@@ -731,8 +743,7 @@ void opt_var_def() {
         // Variable is declared
         is_initialized = false;
 
-        peek();
-        if (token_buffer->type == TOKEN_EQ) {
+        if (peek(0)->type == TOKEN_EQ) {
             vardef_assign = true;
             assign();
             // Variable is defined
@@ -743,7 +754,7 @@ void opt_var_def() {
             current_token = get_next_token();
         }
     }
-    else if (token_buffer->type == TOKEN_EQ) {
+    else if (peek(0)->type == TOKEN_EQ) {
         vardef_assign = true;
         assign();
         // Variable is defined
@@ -770,20 +781,19 @@ void assign() {
 
         // Looking for a function call
         if (current_token->type == TOKEN_ID) {
-            peek();
-            if (token_buffer->type == TOKEN_LPAR) {
+            if (peek(0)->type == TOKEN_LPAR) {
                 // Expecting user-defined function
                 func_call();
                 callee_list = callee_list->next;
 
             }
             else {
-                // In queue->first->next should be the data type of the variable, if it's NULL, the data type is unknown and should be determined by expression
-                if (queue->first->next == NULL) {
+                // In queue_at(queue, 1) should be the data type of the variable, if it's NULL, the data type is unknown and should be determined by expression
+                if (queue->count < 2) {
                     call_expr_parser(UNKNOWN); // In type_of_expr should be the data type of the expression
                 }
                 else {
-                    call_expr_parser(convert_dt(queue->first->next->token));
+                    call_expr_parser(convert_dt(queue_at(queue, 1)));
                 }
             }
         }
@@ -809,17 +819,17 @@ void assign() {
             callee_list = callee_list->next;
         }
         else {
-            // In queue->first->next should be the data type of the variable, if it's NULL, the data type is unknown and should be determined by expression
-            if (queue->first->next == NULL) {
+            // In queue_at(queue, 1) should be the data type of the variable, if it's NULL, the data type is unknown and should be determined by expression
+            if (queue->count < 2) {
                 call_expr_parser(UNKNOWN); // In type_of_expr should be the data type of the expression
             }
             else {
-                call_expr_parser(convert_dt(queue->first->next->token));
+                call_expr_parser(convert_dt(queue_at(queue, 1)));
             }
         }    
     }
     else { // Assigning to already defined variable
-        forest_node *scope = forest_search_scope(active, var_name);
+        forest_node *scope = forest_search_scope(var_name);
         AVL_tree *symbol = symtable_search(scope->symtable, var_name);
         type_of_assignee = symbol->data->data_type;
 
@@ -838,13 +848,12 @@ void assign() {
 
         // Looking for function call
         if (current_token->type == TOKEN_ID) {
-            peek();
-            if (token_buffer->type == TOKEN_LPAR) {
+            if (peek(0)->type == TOKEN_LPAR) {
                 // Expecting user-defined function
                 func_call();
                 
-                instruction *inst = inst_init(VAR_ASSIGN, scope->frame, renamer(symbol), 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(VAR_ASSIGN, scope->frame, renamer(symbol), 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
 
                 callee_list = callee_list->next;
             }
@@ -852,8 +861,8 @@ void assign() {
                 call_expr_parser(symbol->data->data_type);
 
                 // CODEGEN
-                instruction *inst = inst_init(VAR_ASSIGN, scope->frame, renamer(symbol), 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(VAR_ASSIGN, scope->frame, renamer(symbol), 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
             }
         }
         else if (current_token->type == TOKEN_KEYWORD && current_token->value.keyword != KW_NIL) {
@@ -876,8 +885,8 @@ void assign() {
             }
             func_call();
         
-            instruction *inst = inst_init(VAR_ASSIGN, scope->frame, renamer(symbol), 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(VAR_ASSIGN, scope->frame, renamer(symbol), 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
 
             callee_list = callee_list->next;
 
@@ -886,8 +895,8 @@ void assign() {
             call_expr_parser(symbol->data->data_type);
 
             // CODEGEN
-            instruction *inst = inst_init(VAR_ASSIGN, active->frame, renamer(symbol), 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(VAR_ASSIGN, active->frame, renamer(symbol), 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
         }
     }    
 }
@@ -897,8 +906,7 @@ void func_call() {
     // <func_call> -> id ( <args> )
 
     // Store the function's name for later usage (for codegen)
-    char *func_name = allocate_memory(sizeof(char) * strlen(current_token->value.vector->array) + 1);
-    func_name = strcpy(func_name, current_token->value.vector->array);
+    char *func_name = current_token->value.name;
 
     insert_callee_into_list(callee_list, func_name);
 
@@ -929,8 +937,8 @@ void func_call() {
 
     if (!function_write) {
         // CODEGEN
-        instruction *inst = inst_init(FUNC_CALL_START, 'G', NULL, 0, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(FUNC_CALL_START, 'G', NULL, 0, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
     }
 
     // Get TOKEN_LPAR from buffer
@@ -941,11 +949,14 @@ void func_call() {
     if (current_token->type == TOKEN_RPAR) {
         if (!function_write) {
             // CODEGEN
-            instruction *func_call = inst_init(FUNC_CALL, 'G', func_name, 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, func_call);
-            // CODEGEN
-            instruction *retval = inst_init(FUNC_CALL_RETVAL, 'G', NULL, 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, retval);
+            instruction func_call = inst_init(FUNC_CALL, 'G', func_name, 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &func_call);
+            // Return value of the call without assignment is not used, it is not pushed at all, so callee validation has no instruction to remove later
+            if (callee_list->callee->return_type != VOID) {
+                // CODEGEN
+                instruction retval = inst_init(FUNC_CALL_RETVAL, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &retval);
+            }
         }
         current_token = get_next_token();
 
@@ -960,8 +971,7 @@ void func_call() {
 void args() {
     // <args> -> eps | <arg> <args_n>
 
-    peek();
-    if (token_buffer->type == TOKEN_RPAR) {
+    if (peek(0)->type == TOKEN_RPAR) {
 
         // Get TOKEN_RPAR from buffer
         current_token = get_next_token();
@@ -992,10 +1002,9 @@ void arg() {
 
     if (current_token->type == TOKEN_ID) {
 
-        peek();
-        if (token_buffer->type == TOKEN_COLON) {
+        if (peek(0)->type == TOKEN_COLON) {
             // <arg> -> id : exp
-            insert_name_into_callee(callee_list->callee, current_token->value.vector->array);
+            insert_name_into_callee(callee_list->callee, current_token->value.name);
 
             // Get TOKEN_COLON from buffer
             current_token = get_next_token();
@@ -1003,7 +1012,7 @@ void arg() {
             current_token = get_next_token();
         }
         else { // Calling without name
-            insert_name_into_callee(callee_list->callee, "_");
+            insert_name_into_callee(callee_list->callee, intern_str("_"));
 
         }
     }
@@ -1011,11 +1020,11 @@ void arg() {
         error_exit(ERROR_SYN, "PARSER", "Unexpected token in function call, underscore cannot be used as argument's name");
     }
     else { // Calling without name and the first token of expression is not id
-        insert_name_into_callee(callee_list->callee, "_");
+        insert_name_into_callee(callee_list->callee, intern_str("_"));
     }
 
     if (current_token->type == TOKEN_ID) {
-        AVL_tree *symbol = forest_search_symbol(active, current_token->value.vector->array);
+        AVL_tree *symbol = forest_search_symbol(current_token->value.name);
         if (symbol == NULL) {
             error_exit(ERROR_SEM_UNDEF_VAR, "PARSER", "Variable in function call passed as argument is not declared");
         }
@@ -1041,8 +1050,8 @@ void arg() {
 
     if (!function_write) {
         // CODEGEN
-        instruction *inst = inst_init(ADD_ARG, 'G', NULL, 0, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(ADD_ARG, 'G', NULL, 0, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
     }
 }
 
@@ -1073,6 +1082,7 @@ void condition() {
     sprintf(node_name, "if_%d", ifelse_cnt);
     char *node_name2 = (char*)allocate_memory(sizeof(char) * 20);
     strcpy(node_name2, node_name);
+    inst_list_own_name(inst_list, node_name2);
 
     MAKE_CHILDREN_IN_FOREST(W_IF, node_name2);
     active->cond_cnt = ifelse_cnt;
@@ -1088,7 +1098,7 @@ void condition() {
 
         if (current_token->type == TOKEN_ID) {
             // Check if the id is in symtable, so the variable is declared
-            AVL_tree *symbol = forest_search_symbol(active, current_token->value.vector->array);
+            AVL_tree *symbol = forest_search_symbol(current_token->value.name);
             symbol_q = symbol; // For later usage (converting optional type to non-optional and back)
             if (symbol == NULL) {
                 error_exit(ERROR_SEM_UNDEF_VAR, "PARSER", "Variable is not declared");
@@ -1106,11 +1116,11 @@ void condition() {
                 current_token = get_next_token();
 
                 // CODEGEN
-                instruction *inst1 = inst_init(IF_LABEL, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst1);
+                instruction inst1 = inst_init(IF_LABEL, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst1);
                 vardef_outermost_while(IF_DEFVAR, renamer(symbol), active->cond_cnt);
-                instruction *inst = inst_init(IF_LET, active->frame, renamer(symbol), active->cond_cnt, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(IF_LET, active->frame, renamer(symbol), active->cond_cnt, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
             }
         }
         else {
@@ -1121,11 +1131,11 @@ void condition() {
         call_expr_parser(BOOL);
 
         // CODEGEN
-        instruction *inst1 = inst_init(IF_LABEL, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst1);
+        instruction inst1 = inst_init(IF_LABEL, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst1);
         vardef_outermost_while(IF_DEFVAR, NULL, active->cond_cnt);
-        instruction *inst = inst_init(IF, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(IF, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
     }
 
 
@@ -1152,12 +1162,13 @@ void condition() {
                 sprintf(node_name, "else_%d", cnt);
                 char *node_name3 = (char*)allocate_memory(sizeof(char) * 20);
                 strcpy(node_name3, node_name);
+                inst_list_own_name(inst_list, node_name3);
                 MAKE_CHILDREN_IN_FOREST(W_ELSE, node_name3);
                 active->cond_cnt = cnt;
 
                 // CODEGEN
-                instruction *inst = inst_init(ELSE, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(ELSE, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
 
                 current_token = get_next_token();
 
@@ -1174,8 +1185,8 @@ void condition() {
                         active->cond_cnt = cnt_top(cnt_stack); // get ifelse_cnt from stack
                         
                         // CODEGEN
-                        instruction *inst = inst_init(IFELSE_END, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
-                        inst_list_insert_last(inst_list, inst);
+                        instruction inst = inst_init(IFELSE_END, active->frame, NULL, active->cond_cnt, 0, 0.0, NULL);
+                        inst_list_insert_last(inst_list, &inst);
 
                         cnt_pop(cnt_stack); // Pop ifelse_cnt from stack
 
@@ -1212,28 +1223,33 @@ void cycle() {
     sprintf(node_name, "while_%d", while_cnt);
     char *node_name1 = (char*)allocate_memory(sizeof(char) * 20);
     strcpy(node_name1, node_name);
+    inst_list_own_name(inst_list, node_name1);
   
     while_cnt++;
     // Variables declared in while loop have to be pushed outside the while loop in codegen
-    forest_node *outermost_while = forest_search_while(active);
+    bool outermost = outermost_while_anchor == INST_NONE;
     MAKE_CHILDREN_IN_FOREST(W_WHILE, node_name1);
 
     // CODEGEN
-    if (outermost_while == NULL) {
+    if (outermost) {
         // CODEGEN
-        instruction *inst = inst_init(WHILE_COND_DEF, active->frame, node_name1, 0, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(WHILE_COND_DEF, active->frame, node_name1, 0, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
     }
     else {
-        inst_list_search_while(inst_list, outermost_while->name); // Int_list->active is now set on the outermost while -> insert before it
+        inst_list_activate(inst_list, outermost_while_anchor); // Inst_list->active is now set on the outermost while -> insert before it
         // CODEGEN
-        instruction *inst = inst_init(WHILE_COND_DEF, active->frame, node_name1, 0, 0, 0.0, NULL);
-        inst_list_insert_before(inst_list, inst);
+        instruction inst = inst_init(WHILE_COND_DEF, active->frame, node_name1, 0, 0, 0.0, NULL);
+        inst_list_insert_before(inst_list, &inst);
     }
 
     // CODEGEN
-    instruction *inst1 = inst_init(WHILE_START, 'G', node_name1, 0, 0, 0.0, NULL);
-    inst_list_insert_last(inst_list, inst1);
+    instruction inst1 = inst_init(WHILE_START, 'G', node_name1, 0, 0, 0.0, NULL);
+    inst_list_insert_last(inst_list, &inst1);
+    if (outermost) {
+        // The index of the instruction stays the same until the loop is closed, whatever is inserted before it
+        outermost_while_anchor = inst_list->last;
+    }
 
     current_token = get_next_token();
 
@@ -1243,8 +1259,8 @@ void cycle() {
     if (current_token->type == TOKEN_LEFT_BRACKET) {
        
         // CODEGEN
-        instruction *inst = inst_init(WHILE_DO, active->frame, node_name1, 0, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(WHILE_DO, active->frame, node_name1, 0, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
 
         current_token = get_next_token();
 
@@ -1253,8 +1269,11 @@ void cycle() {
         if (current_token->type == TOKEN_RIGHT_BRACKET) {
 
             // CODEGEN
-            instruction *inst = inst_init(WHILE_END, active->frame, node_name1, 0, 0, 0.0, NULL);
-            inst_list_insert_last(inst_list, inst);
+            instruction inst = inst_init(WHILE_END, active->frame, node_name1, 0, 0, 0.0, NULL);
+            inst_list_insert_last(inst_list, &inst);
+            if (outermost) {
+                outermost_while_anchor = INST_NONE;
+            }
             
             // Closing bracket of while statement, go back to parent in forest
             BACK_TO_PARENT_IN_FOREST;
@@ -1294,6 +1313,10 @@ int parser_parse_please () {
     queue = (queue_t*)allocate_memory(sizeof(queue_t));
     init_queue(queue);
 
+    // Lookahead window between the scanner and the parser
+    lookahead = (queue_t*)allocate_memory(sizeof(queue_t));
+    init_queue(lookahead);
+
     // Forest for the whole program, needed for IR of compiler
     forest_node *global = forest_insert_global();
     active = global; // Setting the Active pointer to root of the forest
@@ -1301,6 +1324,17 @@ int parser_parse_please () {
     // The built-ins are by default children of the forest's root (GS)
     insert_built_in_functions_into_forest();
 
+    // The whole source code is loaded at once, the scanner runs over it in memory
+    source_init();
+
+    // Large source codes are scanned on several threads in advance if it is enabled
+    parallel_lex();
+
+    // The rest is scanned on own thread ahead of the parser if it is enabled
+    token_pipe_start();
+    // Streamed code is generated on own thread behind the parser if it is enabled
+    codegen_pipe_start();
+
     // Loading the first token
     current_token = get_next_token();
 
@@ -1321,6 +1355,14 @@ int parser_parse_please () {
     cnt_dispose_stack(cnt_stack);
     inst_list_dispose(inst_list);
     free(built_in_defs);
+    queue_dispose(queue);
+    free(queue);
+    queue_dispose(lookahead);
+    free(lookahead);
+    token_pipe_stop();
+    source_dispose();
+    token_arena_dispose();
+    intern_dispose();
 
     // If the program gets to this point, it means that it was successfully parsed
     return 0;
@@ -1331,12 +1373,13 @@ int parser_parse_please () {
 // Function for renaming the node, needed for codegen
 char *renamer(AVL_tree *node) {
     if (node != NULL) {
-        vector *v = vector_init();
-        for (int i = 0; i < node->nickname; i++) {
-            vector_append(v, '*');
-        }
-        vector_str_append(v, node->key);
-        return v->array;
+        size_t key_length = strlen(node->key);
+        char *name = (char*)allocate_memory(node->nickname + key_length + 1);
+        memset(name, '*', node->nickname);
+        memcpy(name + node->nickname, node->key, key_length + 1);
+        // The name is used only by the instructions, it is freed together with them
+        inst_list_own_name(inst_list, name);
+        return name;
     }
     else {
         return NULL;
@@ -1371,83 +1414,142 @@ void callee_validation(forest_node *global){
         if (func_def == NULL) {
             error_exit(ERROR_SEM_UNDEF_FUN, "PARSER", "Function is not defined");
         }
-        // If the function is void, there has to be removed the expected return value from the ifjcode
-        if (callee_list_first->callee->return_type == VOID && strcmp(func_def->name, "write") != 0) {
-            inst_list_search_void_func_call(inst_list, callee_list_first->callee->name);
-            inst_list_delete_after(inst_list);
-        }
-        if (callee_list_first->callee->arg_count != func_def->param_cnt && strcmp(func_def->name, "write") != 0) { // In case of built-in write function, the number of arguments is not checked
-            error_exit(ERROR_SEM_TYPE, "PARSER", "Number of arguments in function call does not match the number of parameters in function definition");
+        callee_validate(func_def, callee_list_first->callee);
+        callee_list_first = callee_list_first->next; // Move to the next function call
+    }
+}
+
+// Validating one function call against the definition of the function
+void callee_validate(forest_node *func_def, callee_t *callee) {
+    char *write_name = intern_str("write");
+    if (callee->arg_count != func_def->param_cnt && func_def->name != write_name) { // In case of built-in write function, the number of arguments is not checked
+        error_exit(ERROR_SEM_TYPE, "PARSER", "Number of arguments in function call does not match the number of parameters in function definition");
+    } else {
+        // Check if the return type of the function call matches the return type in function definition (ignore when the callee's return type is void -> not assigning retval)
+        if (callee->return_type != (symtable_search(func_def->symtable, func_def->name))->data->return_type && callee->return_type != VOID) {
+            error_exit(ERROR_SEM_TYPE, "PARSER", "Function's return type does not match the return type in function definition");
         } else {
-            // Check if the return type of the function call matches the return type in function definition (ignore when the callee's return type is void -> not assigning retval)
-            if (callee_list_first->callee->return_type != (symtable_search(func_def->symtable, func_def->name))->data->return_type && callee_list_first->callee->return_type != VOID) {
-                error_exit(ERROR_SEM_TYPE, "PARSER", "Function's return type does not match the return type in function definition");
-            } else {
-                for (int i = 1; i <= func_def->param_cnt; i++) {
-                    // Check if the variables given as args was initialized
-                    if (callee_list_first->callee->args_initialized[i] == false) {
-                        error_exit(ERROR_SEM_UNDEF_VAR, "PARSER", "Argument in function call is not initialized");
-                    }
+            for (int i = 1; i <= func_def->param_cnt; i++) {
+                // Check if the variables given as args was initialized
+                if (callee->args_initialized[i] == false) {
+                    error_exit(ERROR_SEM_UNDEF_VAR, "PARSER", "Argument in function call is not initialized");
+                }
 
-                    AVL_tree *param = symtable_find_param(func_def->symtable, i);
-                    if (strcmp(callee_list_first->callee->args_names[i], param->data->param_name) != 0) {
-                        error_exit(ERROR_SEM_OTHER, "PARSER", "Argument's name does not match the parameter's name in function definition");
-                    }
-                    // Check if the argument's type matches the parameter's type, if the parameter's type include '?', the argument's type can be nil
-                    switch (param->data->param_type) {
-                        case INT_QM:
-                            if (callee_list_first->callee->args_types[i] != INT_QM && 
-                                callee_list_first->callee->args_types[i] != INT &&
-                                callee_list_first->callee->args_types[i] != NIL) {
-                                error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
-                            }
-                            break;
-                        case DOUBLE_QM:
-                            if (callee_list_first->callee->args_types[i] != DOUBLE_QM &&
-                                callee_list_first->callee->args_types[i] != DOUBLE &&
-                                callee_list_first->callee->args_types[i] != NIL) {
-                                error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
-                            }
-                            break;
-                        case STRING_QM:
-                            if (callee_list_first->callee->args_types[i] != STRING_QM &&
-                                callee_list_first->callee->args_types[i] != STRING &&
-                                callee_list_first->callee->args_types[i] != NIL) {
-                                error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
-                            }
-                            break;
-                        case INT:
-                        case DOUBLE:
-                        case STRING:
-                            if (callee_list_first->callee->args_types[i] != param->data->param_type) {
-                                error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
-                            }
-                            break;
-                        default:
-                            break;
-                    }
+                forest_param *param = &func_def->params[i - 1];
+                if (callee->args_names[i] != param->label) {
+                    error_exit(ERROR_SEM_OTHER, "PARSER", "Argument's name does not match the parameter's name in function definition");
                 }
-                // Write() has to be treated separately, since it have various number of arguments
-                if (strcmp(func_def->name, "write") == 0) {
-                    for (int i = 1; i <= callee_list_first->callee->arg_count; i++) {
-                        if (callee_list_first->callee->args_initialized[1] == false) {
-                            error_exit(ERROR_SEM_UNDEF_VAR, "PARSER", "Argument in function call is not initialized");
+                // Check if the argument's type matches the parameter's type, if the parameter's type include '?', the argument's type can be nil
+                switch (param->type) {
+                    case INT_QM:
+                        if (callee->args_types[i] != INT_QM && 
+                            callee->args_types[i] != INT &&
+                            callee->args_types[i] != NIL) {
+                            error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
+                        }
+                        break;
+                    case DOUBLE_QM:
+                        if (callee->args_types[i] != DOUBLE_QM &&
+                            callee->args_types[i] != DOUBLE &&
+                            callee->args_types[i] != NIL) {
+                            error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
                         }
+                        break;
+                    case STRING_QM:
+                        if (callee->args_types[i] != STRING_QM &&
+                            callee->args_types[i] != STRING &&
+                            callee->args_types[i] != NIL) {
+                            error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
+                        }
+                        break;
+                    case INT:
+                    case DOUBLE:
+                    case STRING:
+                        if (callee->args_types[i] != param->type) {
+                            error_exit(ERROR_SEM_TYPE, "PARSER", "Argument's type does not match the parameter's type in function definition");
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+            // Write() has to be treated separately, since it have various number of arguments
+            if (func_def->name == write_name) {
+                for (int i = 1; i <= callee->arg_count; i++) {
+                    if (callee->args_initialized[1] == false) {
+                        error_exit(ERROR_SEM_UNDEF_VAR, "PARSER", "Argument in function call is not initialized");
                     }
                 }
             }
         }
-        callee_list_first = callee_list_first->next; // Move to the next function call
     }
 }
 
+// Streaming mode, generating the code of the finished top-level statement or function definition and freeing it
+void stream_generated_code(forest_node *global) {
+    bool new_function = false;
+    for (int i = streamed_children; i < global->children_count; i++) {
+        if (global->children[i]->keyword == W_FUNCTION) {
+            new_function = true;
+        }
+    }
+
+    // Calls of the functions defined so far are validated, the rest waits for the definition like a patch record
+    callee_list_t **link = new_function ? &callee_list_first : unchecked_callee;
+    while ((*link)->callee != NULL) {
+        callee_list_t *record = *link;
+        forest_node *func_def = forest_search_function(global, record->callee->name);
+        if (func_def == NULL) {
+            link = &record->next;
+            continue;
+        }
+        callee_validate(func_def, record->callee);
+        *link = record->next;
+        callee_dispose(record->callee);
+        free(record);
+    }
+    unchecked_callee = link;
+
+    for (int i = streamed_children; i < global->children_count; i++) {
+        forest_node *node = global->children[i];
+        if (node->keyword == W_FUNCTION && symtable_search(node->symtable, node->name)->data->return_type != VOID) {
+            validate_forest(node->children[0]);
+        }
+    }
+
+    codegen_generate_pending(inst_list);
+
+    // Function nodes stay for the calls after them, bodies of the functions and top-level blocks are not needed anymore
+    int kept = streamed_children;
+    for (int i = streamed_children; i < global->children_count; i++) {
+        forest_node *node = global->children[i];
+        if (node->keyword == W_FUNCTION) {
+            for (int j = 0; j < node->children_count; j++) {
+                forest_dispose(node->children[j]);
+            }
+            free(node->children);
+            node->children = NULL;
+            node->children_count = 0;
+            node->children_capacity = 0;
+            global->children[kept++] = node;
+        }
+        else {
+            forest_dispose(node);
+        }
+    }
+    global->children_count = kept;
+    streamed_children = kept;
+}
+
 // Validating return statements
 void return_logic_validation (forest_node *global) {
     // Go through all functions in global scope (starting after all built-in functions)
     for (int i = AFTER_BUILTIN; i < global->children_count; i++) {
         if (global->children[i]->keyword == W_FUNCTION) { // Work only with non-void functions
             // Look at the children of the first children of the global scope - at the function's body
-            if (symtable_search(global->children[i]->symtable, global->children[i]->name)->data->return_type != VOID) {
+            // Bodies of the functions generated in streaming mode were validated and freed already
+            if (symtable_search(global->children[i]->symtable, global->children[i]->name)->data->return_type != VOID &&
+                global->children[i]->children_count > 0) {
                 validate_forest(global->children[i]->children[0]);
             }
         }
@@ -1502,17 +1604,16 @@ bool validate_forest_node(forest_node *node) {
 
 // Function for inserting built-in functions into the forest
 void vardef_outermost_while(inst_type type, char *nickname, int cnt) {
-    forest_node *outermost_while = forest_search_while(active); // NULL if not anywhere in while, outermost while otherwise
-    if (outermost_while == NULL) { 
+    if (outermost_while_anchor == INST_NONE) { // Not anywhere in while
         // CODEGEN
-        instruction *inst = inst_init(type, active->frame, nickname, cnt, 0, 0.0, NULL);
-        inst_list_insert_last(inst_list, inst);
+        instruction inst = inst_init(type, active->frame, nickname, cnt, 0, 0.0, NULL);
+        inst_list_insert_last(inst_list, &inst);
     }
     else {
-        inst_list_search_while(inst_list, outermost_while->name); // Int_list->active is now set on the outermost while -> insert before it
+        inst_list_activate(inst_list, outermost_while_anchor); // Inst_list->active is now set on the outermost while -> insert before it
         // CODEGEN
-        instruction *inst = inst_init(type, active->frame, nickname, cnt, 0, 0.0, NULL);
-        inst_list_insert_before(inst_list, inst);
+        instruction inst = inst_init(type, active->frame, nickname, cnt, 0, 0.0, NULL);
+        inst_list_insert_before(inst_list, &inst);
     }
 }
 
@@ -1577,8 +1678,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_RD_STR:
             if (!built_in_defs->readString_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(READ_STRING, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(READ_STRING, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->readString_defined = true;
             }
             break;
@@ -1586,8 +1687,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_RD_INT:
             if (!built_in_defs->readInt_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(READ_INT, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(READ_INT, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->readInt_defined = true;
             }
             break;
@@ -1595,8 +1696,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_RD_DBL:
             if (!built_in_defs->readDouble_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(READ_DOUBLE, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(READ_DOUBLE, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->readDouble_defined = true;
             }
             break;
@@ -1604,8 +1705,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_INT_2_DBL:
             if (!built_in_defs->Int2Double_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(INT2DOUBLE, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(INT2DOUBLE, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->Int2Double_defined = true;
             }
             break;
@@ -1613,8 +1714,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_DBL_2_INT:
             if (!built_in_defs->Double2Int_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(DOUBLE2INT, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(DOUBLE2INT, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->Double2Int_defined = true;
             }
             break;
@@ -1622,8 +1723,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_LENGHT:
             if (!built_in_defs->length_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(LENGTH, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(LENGTH, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->length_defined = true;
             }
             break;
@@ -1631,8 +1732,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_SUBSTR:
             if (!built_in_defs->substring_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(SUBSTRING, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(SUBSTRING, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->substring_defined = true;
             }
             break;
@@ -1640,8 +1741,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_ORD:
             if (!built_in_defs->ord_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(ORD, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(ORD, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->ord_defined = true;
             }
             break;
@@ -1649,8 +1750,8 @@ void define_built_in_function(builtin_defs *built_in_defs) {
         case KW_CHR:
             if (!built_in_defs->chr_defined) {
                 // CODEGEN
-                instruction *inst = inst_init(CHR, 'G', NULL, 0, 0, 0.0, NULL);
-                inst_list_insert_last(inst_list, inst);
+                instruction inst = inst_init(CHR, 'G', NULL, 0, 0, 0.0, NULL);
+                inst_list_insert_last(inst_list, &inst);
                 built_in_defs->chr_defined = true;
             }
             break;
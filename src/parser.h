@@ -13,11 +13,12 @@
 #ifndef IFJ_PARSER_H
 #define IFJ_PARSER_H
 
+#include "callee.h"
 #include "scanner.h"
 #include "string_vector.h"
 
 #define MAKE_CHILDREN_IN_FOREST(kw, name) forest_insert(active, kw, name , &active);
-#define BACK_TO_PARENT_IN_FOREST active = active->parent;
+#define BACK_TO_PARENT_IN_FOREST forest_leave(&active);
 
 // First 10 function definitions in global scope are built-in functions
 #define AFTER_BUILTIN 10
@@ -52,9 +53,12 @@ data_type convert_dt(token_t* token);
 
 
 /**
- * @brief Peek to the next token before calling get_next_token
+ * @brief Peek to the tokens ahead before calling get_next_token, no token is consumed
+ * 
+ * @param k Position of the token after the current one, 0 is the next token
+ * @return token_t* Token k positions ahead
  */
-void peek();
+token_t *peek(unsigned k);
 
 
 /**
@@ -204,6 +208,23 @@ forest_node* check_return_stmt(forest_node *node);
  */
 void callee_validation(forest_node *global);
 
+/**
+ * @brief Validating one function call against the definition of the function
+ * 
+ * @param func_def Forest node of the called function
+ * @param callee Function call
+ */
+void callee_validate(forest_node *func_def, callee_t *callee);
+
+/**
+ * @brief Streaming mode - validating and generating the code of the finished top-level statement or function definition,
+ *        then freeing its instructions, forest subtree and the validated function calls
+ * 
+ * @note Calls of functions not defined yet stay in the callee list until their definition is finished
+ * @param global Global forest node
+ */
+void stream_generated_code(forest_node *global);
+
 
 /**
  * @brief Validating return logic in all function definitions (if all paths return)
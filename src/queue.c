@@ -13,53 +13,76 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
+#include <stdlib.h>
 
 // initialize the queue
 void init_queue(queue_t *queue) {
-    queue->first = NULL;
-    queue->last = NULL;
+    queue->tokens = NULL;
+    queue->capacity = 0;
+    queue->head = 0;
+    queue->count = 0;
 }
 
-// add the token to the end of the queue
-void queue_push(queue_t *queue, token_t *token){
-    queue_item_t *new_item = (queue_item_t*)allocate_memory(sizeof(queue_item_t));
+// double the capacity, the tokens are moved to the beginning of the new buffer in order
+static void queue_grow(queue_t *queue) {
+    unsigned capacity = queue->capacity == 0 ? QUEUE_INIT : 2 * queue->capacity;
+    token_t **tokens = (token_t**)allocate_memory(capacity * sizeof(token_t*));
+    for (unsigned i = 0; i < queue->count; i++) {
+        tokens[i] = queue->tokens[(queue->head + i) & (queue->capacity - 1)];
+    }
+    free(queue->tokens);
+    queue->tokens = tokens;
+    queue->capacity = capacity;
+    queue->head = 0;
+}
 
-    new_item->next = NULL;
-    new_item->token = token;
+// add the token to the end of the queue
+void queue_push(queue_t *queue, token_t *token) {
+    if (queue->count == queue->capacity) {
+        queue_grow(queue);
+    }
+    queue->tokens[(queue->head + queue->count) & (queue->capacity - 1)] = token;
+    queue->count++;
+}
 
-    if (queue->first == NULL) {
-        queue->first = new_item;
-        queue->last = new_item;
-    } 
-    else if (queue->first->next == NULL) {
-        queue->first->next = new_item;
-        queue->last = new_item;
+token_t *queue_pop(queue_t *queue) {
+    if (queue->count == 0) {
+        return NULL;
     }
-    else {
-        queue->last->next = new_item;
-        queue->last = new_item;
+    token_t *token = queue->tokens[queue->head];
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+    queue->count--;
+    return token;
+}
+
+token_t *queue_at(queue_t *queue, unsigned index) {
+    if (index >= queue->count) {
+        return NULL;
     }
+    return queue->tokens[(queue->head + index) & (queue->capacity - 1)];
+}
+
+void queue_clear(queue_t *queue) {
+    queue->head = 0;
+    queue->count = 0;
 }
 
 void queue_dispose(queue_t *queue) {
-    if (queue != NULL || queue->first != NULL) {
-        queue_item_t *current = queue->first;
-        while (current != NULL) {
-            queue_item_t *tmp = current;
-            current = current->next;
-            free(tmp);
-        }
-        queue->first = NULL;
-        queue->last = NULL;
-        queue = NULL;
-    }
+    free(queue->tokens);
+    init_queue(queue);
 }
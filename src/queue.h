@@ -16,16 +16,14 @@
 #include <stdbool.h>
 #include "scanner.h"
 
-// Structure for queue item
-typedef struct queue_item {
-    token_t *token;
-    struct queue_item *next;
-} queue_item_t;
+#define QUEUE_INIT 8 // initial capacity of the ring buffer, power of two, it is doubled when full
 
-// Structure for queue
+// Ring buffer of tokens, used for lookahead of the parser and for tokens of definitions
 typedef struct queue {
-    queue_item_t *first;
-    queue_item_t *last;
+    token_t **tokens;
+    unsigned capacity; // power of two, 0 before the first push
+    unsigned head; // index of the first token
+    unsigned count; // number of tokens in the queue
 } queue_t;
 
 /**
@@ -36,7 +34,7 @@ typedef struct queue {
 void init_queue(queue_t *queue);
 
 /**
- * @brief Pushes a token to the queue
+ * @brief Pushes a token to the end of the queue
  * 
  * @param queue Pointer to the queue
  * @param token Pointer to the token
@@ -44,7 +42,31 @@ void init_queue(queue_t *queue);
 void queue_push(queue_t *queue, token_t *token);
 
 /**
- * @brief Cleaning of the queue
+ * @brief Removes the first token of the queue
+ * 
+ * @param queue Pointer to the queue
+ * @return token_t* The first token, NULL if the queue is empty
+ */
+token_t *queue_pop(queue_t *queue);
+
+/**
+ * @brief Returns the token at the given position without removing it
+ * 
+ * @param queue Pointer to the queue
+ * @param index Position of the token, 0 is the first one
+ * @return token_t* Token at the position, NULL if the queue is shorter
+ */
+token_t *queue_at(queue_t *queue, unsigned index);
+
+/**
+ * @brief Removes all tokens of the queue, its buffer is kept for the next ones
+ * 
+ * @param queue Pointer to the queue
+ */
+void queue_clear(queue_t *queue);
+
+/**
+ * @brief Frees the buffer of the queue, tokens are owned by the token arena
  * 
  * @param queue Pointer to the queue
  */
@@ -9,765 +9,602 @@
  * @author Samuel Hejnicek <xhejni00>
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "scanner_table.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 #include <ctype.h>
-
-keyword_t compare_keyword(vector* v){
-    if(vector_str_cmp(v, "Double")){
-        return KW_DOUBLE;
-    } else if (vector_str_cmp(v, "else")){
-        return KW_ELSE;
-    } else if (vector_str_cmp(v, "func")){
-        return KW_FUNC;
-    } else if (vector_str_cmp(v, "if")){
-        return KW_IF;
-    } else if (vector_str_cmp(v, "Int")){
-        return KW_INT;
-    } else if (vector_str_cmp(v, "let")){
-        return KW_LET;
-    } else if (vector_str_cmp(v, "nil")){
-        return KW_NIL;
-    } else if (vector_str_cmp(v, "return")){
-        return KW_RETURN;
-    } else if (vector_str_cmp(v, "String")){
-        return KW_STRING;
-    } else if (vector_str_cmp(v, "var")){
-        return KW_VAR;
-    } else if (vector_str_cmp(v, "while")){
-        return KW_WHILE;
-    } else if (vector_str_cmp(v, "readString")){
-        return KW_RD_STR;
-    } else if (vector_str_cmp(v, "readInt")){
-        return KW_RD_INT;
-    } else if (vector_str_cmp(v, "readDouble")){
-        return KW_RD_DBL;
-    } else if (vector_str_cmp(v, "write")){
-        return KW_WRT;
-    } else if (vector_str_cmp(v, "Int2Double")){
-        return KW_INT_2_DBL;
-    } else if (vector_str_cmp(v, "Double2Int")){
-        return KW_DBL_2_INT;
-    } else if (vector_str_cmp(v, "length")){
-        return KW_LENGHT;
-    } else if (vector_str_cmp(v, "substring")){
-        return KW_SUBSTR;
-    } else if (vector_str_cmp(v, "ord")){
-        return KW_ORD;
-    } else if (vector_str_cmp(v, "chr")){
-        return KW_CHR;
-    } else {
-        return DEFAULT_TOKEN_VAL;
+#include <limits.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SOURCE_CHUNK 65536 //size of the first chunk read from stdin when it cannot be mapped
+#define KEYWORD_HASH_SIZE 64 //Number of slots in the perfect hash table of keywords
+#define KEYWORD_MIN_LENGTH 2 //Length of the shortest keyword
+#define KEYWORD_MAX_LENGTH 10 //Length of the longest keyword
+#define NUMBER_MAX_LENGTH 64 //Numbers shorter than this are scanned without the lexeme buffer
+#define FAST_PATH_MAX_MANTISSA (1ULL << 53) //Bigger mantissas are not exact in double
+#define FAST_PATH_MAX_EXPONENT 22 //Bigger powers of ten are not exact in double
+#define INVALID_UTF8_MESSAGE "Source code is not valid UTF-8"
+
+_Thread_local source_t source = {NULL, NULL, NULL, NULL, false}; //Source code the scanner runs over
+static _Thread_local vector* lexeme = NULL; //Buffer the lexemes are read into, reused by all tokens
+static _Thread_local jmp_buf* recovery = NULL; //Lexical errors jump here while the tokens are scanned speculatively
+static _Thread_local bool names_deferred = false; //Names are interned later by the thread stitching the tokens together
+
+//Tokens scanned in advance, get_me_token hands them out instead of scanning
+static struct {
+    token_t* tokens;
+    size_t count;
+    size_t next;
+} prelexed = {NULL, 0, 0};
+
+//Reports lexical error, speculative scanning just stops at it
+static void lex_error(const char* message){
+    if(recovery != NULL){
+        longjmp(*recovery, 1);
     }
+    error_exit(ERROR_LEX, "SCANNER", message);
 }
 
-bool check_indent(int* cnt_array, int size){
-    for(int i = 0; i < size ; i++){
-        //compares value of all counters with the last one which is for indentation
-        if(cnt_array[i] < cnt_array[size]){
-            return false;
-        }
+//Returns next character of the source code, EOF behind its end
+static inline char source_getc(){
+    if(source.cursor < source.end){
+        return *source.cursor++;
+    }
+    //The scanning got to the invalid byte, errors in front of it were reported already
+    if(source.end != source.data_end){
+        lex_error(INVALID_UTF8_MESSAGE);
     }
-    return true;
+    return (char) EOF;
 }
 
-void destroy_token(token_t* token){
-    if(token->value.vector){
-        vector_dispose(token->value.vector);
+//Returns the last read character back to the source code, EOF is not returned just like with ungetc
+static inline void source_ungetc(char c){
+    if((int) c != EOF){
+        source.cursor--;
     }
-    free(token);
-    token = NULL;
 }
 
-void cut_indent(vector* vector, int indent, int lines){
-    //No lines, no whitespaces will be deleted
-    if(lines == 0){
-        return;
+//Whole source code is checked to be valid UTF-8 before it is scanned, byte (char) EOF cannot appear in it then
+//The scanning stops at the first invalid byte, the error is reported when the scanner gets to it
+static void source_validate(){
+    source.data_end = source.end;
+    source.end = (char*) simd_find_invalid_utf8(source.data, source.end);
+}
+
+void source_init(){
+    struct stat info;
+
+    //Regular file starting at its beginning can be mapped into memory as a whole
+    if(fstat(STDIN_FILENO, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 && lseek(STDIN_FILENO, 0, SEEK_CUR) == 0){
+        void* map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+        if(map != MAP_FAILED){
+            posix_madvise(map, info.st_size, POSIX_MADV_SEQUENTIAL);
+            source.data = (char*) map;
+            source.end = source.data + info.st_size;
+            source.cursor = source.data;
+            source.mapped = true;
+            source_validate();
+            return;
+        }
     }
-    //Calculate length of string
-    int len = strlen(vector->array);
-
-    //Counter of EOLs
-    int eol_cnt = 0;
-    
-    //Deletes whitespaces in first line according to indent
-    for(int i = 0; i < indent*2; i++){
-        for(int j = 0; j < len; j++){
-            vector->array[j] = vector->array[j+2];
+
+    //Pipes, terminals and everything else is read at once into growing buffer
+    size_t size = 0;
+    size_t alloc_size = SOURCE_CHUNK;
+    char* data = (char*) allocate_memory(alloc_size);
+    ssize_t read_size;
+    while((read_size = read(STDIN_FILENO, data + size, alloc_size - size)) != 0){
+        if(read_size < 0){
+            free(data);
+            error_exit(ERROR_INTERNAL, "SCANNER", "Reading of the source code failed");
+        }
+        size += read_size;
+        if(size == alloc_size){
+            alloc_size *= 2;
+            data = (char*) reallocate_memory(data, alloc_size);
         }
-        
     }
-    //Finds EOL
-    char* result = strstr(vector->array, "\\010");
-    if(result == NULL){
+    source_init_buffer(data, size);
+}
+
+void source_init_buffer(char* data, size_t size){
+    source.data = data;
+    source.end = data + size;
+    source.cursor = data;
+    source.mapped = false;
+    source_validate();
+}
+
+void source_dispose(){
+    if(source.data == NULL){
         return;
+    }
+    if(source.mapped){
+        munmap(source.data, source.data_end - source.data);
     } else {
-        eol_cnt++;
+        free(source.data);
+    }
+    source.data = source.end = source.data_end = NULL;
+    source.cursor = NULL;
+    scanner_thread_dispose();
+    free(prelexed.tokens);
+    prelexed.tokens = NULL;
+    prelexed.count = prelexed.next = 0;
+}
+
+void scanner_thread_dispose(){
+    if(lexeme != NULL){
+        vector_dispose(lexeme);
+        lexeme = NULL;
+    }
+}
+
+//Perfect hash of keywords, the slot of keyword is (length + 1st char + 2nd char + 7 * last char) % 64
+//Constants were found by exhaustive search over the keyword_t table, every keyword has its own slot
+static const struct keyword_entry {
+    const char* name;
+    int length;
+    keyword_t keyword;
+} keyword_table[KEYWORD_HASH_SIZE] = {
+    [0] = {"let", 3, KW_LET},
+    [2] = {"substring", 9, KW_SUBSTR},
+    [4] = {"Int2Double", 10, KW_INT_2_DBL},
+    [10] = {"readInt", 7, KW_RD_INT},
+    [14] = {"nil", 3, KW_NIL},
+    [20] = {"func", 4, KW_FUNC},
+    [24] = {"else", 4, KW_ELSE},
+    [27] = {"if", 2, KW_IF},
+    [30] = {"String", 6, KW_STRING},
+    [31] = {"return", 6, KW_RETURN},
+    [32] = {"ord", 3, KW_ORD},
+    [36] = {"readDouble", 10, KW_RD_DBL},
+    [38] = {"Int", 3, KW_INT},
+    [39] = {"while", 5, KW_WHILE},
+    [41] = {"Double2Int", 10, KW_DBL_2_INT},
+    [44] = {"chr", 3, KW_CHR},
+    [47] = {"length", 6, KW_LENGHT},
+    [49] = {"write", 5, KW_WRT},
+    [50] = {"readString", 10, KW_RD_STR},
+    [56] = {"var", 3, KW_VAR},
+    [60] = {"Double", 6, KW_DOUBLE},
+};
+
+keyword_t compare_keyword(const char* lexeme, int length){
+    const unsigned char* s = (const unsigned char*) lexeme;
+
+    //Identifiers shorter or longer than any keyword cannot be a keyword
+    if(length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH){
+        return DEFAULT_TOKEN_VAL;
     }
 
-    int index = result - vector->array;
-    //Next line will start after EOL
-    index = index + 4;
+    //One hash and at most one comparison
+    const struct keyword_entry* entry = &keyword_table[(length + s[0] + s[1] + 7 * s[length - 1]) % KEYWORD_HASH_SIZE];
+    if(entry->length == length && memcmp(entry->name, s, length) == 0){
+        return entry->keyword;
+    }
+    return DEFAULT_TOKEN_VAL;
+}
+
+//Powers of ten which are exactly representable in double
+static const double exact_power_of_ten[FAST_PATH_MAX_EXPONENT + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//Parses integer literal straight from the source code, int of IFJcode23 has 64 bits
+static long long parse_integer(const char* start, int length){
+    long long value = 0;
+    for(int i = 0; i < length; i++){
+        int digit = start[i] - '0';
+        if(value > (LLONG_MAX - digit) / 10){
+            lex_error("Integer literal is out of range");
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+//Slow path of doubles, strtod needs terminated copy which is made on the stack
+static double parse_double_slow(const char* start, int length){
+    char number[NUMBER_MAX_LENGTH];
+    if(length < NUMBER_MAX_LENGTH){
+        memcpy(number, start, length);
+        number[length] = '\0';
+        return strtod(number, NULL);
+    }
+    //Unusually long numbers go through the lexeme buffer
+    if(lexeme == NULL){
+        lexeme = vector_init();
+    }
+    vector_clear(lexeme);
+    vector_append_n(lexeme, start, length);
+    return strtod(lexeme->array, NULL);
+}
 
-    //If there are more EOLS skip them
-    while(vector->array[index+2] == '1' && vector->array[index+3] == '0'){
-        index = index + 4;
-        eol_cnt++;
+//Parses decimal or exponent literal straight from the source code
+static double parse_double(const char* start, int length){
+    const char* c = start;
+    const char* end = start + length;
+    uint64_t mantissa = 0; //all digits without the dot
+    int significant = 0; //number of digits of mantissa without leading zeros
+    int exponent = 0; //decimal exponent of the last digit of mantissa
+
+    for(bool fraction = false; c < end && (isdigit(*c) || (*c == '.' && !fraction)); c++){
+        if(*c == '.'){
+            fraction = true;
+            continue;
+        }
+        //More than 19 digits would overflow, such numbers take the slow path anyway
+        if(significant < 19){
+            mantissa = mantissa * 10 + (*c - '0');
+        }
+        if(mantissa != 0){
+            significant++;
+        }
+        if(fraction){
+            exponent--;
+        }
     }
 
-    //Delete whitespaces in other lines too
-    while(lines != 1){
-        for(int i = 0; i < indent*2; i++){
-            for(int j = index; j < len; j++){
-                vector->array[j] = vector->array[j+2];
+    if(c < end){
+        //The automaton guarantees the exponent is e or E, optional sign and digits
+        c++;
+        bool negative = *c == '-';
+        if(*c == '-' || *c == '+'){
+            c++;
+        }
+        int exp_value = 0;
+        for(; c < end; c++){
+            if(exp_value < 100000){
+                exp_value = exp_value * 10 + (*c - '0');
             }
         }
-        char* result = strstr(vector->array, "\\032"); //Je potreba pocitat pocet 010 a potom od te pozice mazat 010
-        if(result == NULL){
+        exponent += negative ? -exp_value : exp_value;
+    }
+
+    //Clinger's fast path, exact mantissa and exact power of ten give correctly rounded result
+    if(significant <= 19 && mantissa <= FAST_PATH_MAX_MANTISSA){
+        if(mantissa == 0){
+            return 0.0;
+        }
+        if(exponent >= 0 && exponent <= FAST_PATH_MAX_EXPONENT){
+            return (double) mantissa * exact_power_of_ten[exponent];
+        }
+        if(exponent < 0 && exponent >= -FAST_PATH_MAX_EXPONENT){
+            return (double) mantissa / exact_power_of_ten[-exponent];
+        }
+    }
+    return parse_double_slow(start, length);
+}
+
+//Copies the plain part of string read so far into buffer, the string is built in buffer from now on
+static inline void materialise_string(vector* buffer, const char* start, bool* materialised){
+    if(!*materialised){
+        vector_append_n(buffer, start, source.cursor - 1 - start);
+        *materialised = true;
+    }
+}
+
+//Sets the lexeme of token to the slice of source code from start to the cursor
+static inline void token_slice(token_t* token, const char* start){
+    token->value.lexeme = start;
+    token->value.length = source.cursor - start;
+}
+
+//Decodes escape sequence behind the backslash of string literal into the buffer
+static void scan_escape(vector* buffer){
+    char readchar = source_getc();
+    switch(readchar){
+        case '"':
+            vector_append(buffer, '"');
+            return;
+        case '\\':
+            vector_append(buffer, '\\');
+            return;
+        case 'n':
+            vector_append(buffer, '\n');
+            return;
+        case 't':
+            vector_append(buffer, '\t');
+            return;
+        case 'r':
+            vector_append(buffer, '\r');
+            return;
+        case 'u':
             break;
+        default:
+            lex_error("Wrong escape sequence letter");
+    }
+
+    //Unicode escape \u{dd} with up to 8 hexadecimal digits
+    if(source_getc() != '{'){
+        lex_error("Wrong hex format '\\u{dd}'");
+    }
+    unsigned int value = 0;
+    int hex_counter = 0;
+    while(isxdigit((unsigned char) (readchar = source_getc()))){
+        //Too many hex characters
+        if(++hex_counter > 8){
+            lex_error("Hex value has to be in hexadecimal format");
         }
-        int index = result - vector->array;
-        lines--;
+        value = value * 16 + (isdigit(readchar) ? readchar - '0' : tolower(readchar) - 'a' + 10);
+    }
+    if(hex_counter == 0 || readchar != '}'){
+        lex_error("Wrong hex format '\\u{dd}'");
     }
+    //Only values of one byte are valid
+    if(value > 0xFF){
+        lex_error("Hex value has more than 2 digits");
+    }
+    vector_append(buffer, (char) value);
 }
 
-token_t* get_me_token(){
-    //Default automata state
-    automat_state_t a_state = S_START;
-
-    //Token inicialization
-    token_t* token = (token_t*)allocate_memory(sizeof(token_t));
-    vector* buffer = vector_init();
-    token->value.vector = NULL;
-    token->prev_was_eol = false;
-    token->value.integer = 0;
-    token->value.type_double = 0.0;
-    token->value.keyword = DEFAULT_TOKEN_VAL;
+//Returns the first quote of the closing delimiter of multiline string starting at the cursor
+static const char* find_multiline_end(){
+    const char* c = source.cursor;
+    while(true){
+        c = simd_skip_string(c, source.end);
+        if(source.end - c < 3){
+            //The string can be cut by the invalid byte rather than by the end of the source code
+            lex_error(source.end != source.data_end ? INVALID_UTF8_MESSAGE : "Multiline string is not terminated");
+            return source.end;
+        }
+        if(c[0] == '\\'){
+            c += 2;
+        } else if(c[0] == '"' && c[1] == '"' && c[2] == '"'){
+            return c;
+        } else {
+            c++;
+        }
+    }
+}
 
-    char readchar, next_char; //current read char and next one
-    char hex[8] = {0}; //array for storing up to 8 hex characters
-    int hex_counter = 0; //counter of hex characters
-    int cnt_open = 0; //counter for openings of multiline comments
-    int cnt_close = 0; //counter for endings of multiline comments
-    int non_null_cnt = 0; //counter of non-null characters when checking hexadecimal value
-    int cnt_array_size = 0; //default size of array of counters
-    int cnt_array_alloc_size = 8; //default allocation size of array for counters
-    int* cnt_array = NULL; //Pointer to array of counters
-    bool is_multiline = false; //Bool value if token is multiline
-    bool only_whitespace = false; //Bool to check if line had only whitespaces used for empty lines in multiline string
+//Scans multiline string behind the EOL of its opening delimiter, indentation is checked and cut off in one pass
+//The value of the string is decoded into the buffer, it is escaped for IFJcode23 by the code generator
+static void scan_multiline_string(token_t* token, vector* buffer){
+    //Whitespaces in front of the closing delimiter are the indentation every line has to start with
+    const char* closing = find_multiline_end();
+    const char* indent = closing;
+    while(indent > source.cursor && (indent[-1] == ' ' || indent[-1] == '\t')){
+        indent--;
+    }
+    if(indent > source.cursor && indent[-1] != '\n'){
+        lex_error("Closing delimiter of multiline string has to be on its own line");
+    }
+    int indent_length = closing - indent;
 
-    while ((readchar = (char) getc(stdin))){
+    //Lines are translated right into the buffer, the EOL in front of the closing line is not part of the string
+    bool first_line = true;
+    while(source.cursor < indent){
+        if(!first_line){
+            vector_append(buffer, '\n');
+        }
+        first_line = false;
+
+        if(memcmp(source.cursor, indent, indent_length) == 0){
+            source.cursor += indent_length;
+        } else {
+            //Only lines of whitespaces can be indented less
+            source.cursor = simd_skip_blanks(source.cursor, indent);
+            if(*source.cursor != '\n'){
+                lex_error("Insufficient indentation of line in multiline string");
+            }
+        }
 
-        switch(a_state)
-        {
-            case (S_START):
-
-                    if(readchar == ':'){
-                        token->type = TOKEN_COLON;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == ','){
-                        token->type = TOKEN_COMMA;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '?'){
-                        a_state = S_QM;
-                        vector_dispose(buffer);
-
-                    } else if(readchar == '('){
-                        a_state = S_START;
-                        token->type = TOKEN_LPAR;
-                        vector_dispose(buffer);
-                        
-                        return token;
-                    } else if(readchar == ')'){
-                        a_state = S_START;
-                        token->type = TOKEN_RPAR;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '{'){
-                        a_state = S_START;
-                        token->type = TOKEN_LEFT_BRACKET;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '}'){
-                        a_state = S_START;
-                        token->type = TOKEN_RIGHT_BRACKET;
-                        vector_dispose(buffer);
-                        return token;
-
-                    }else if(readchar == '>'){
-                        token->type = TOKEN_GREAT;
-
-                        if((next_char = (char) getc(stdin)) == '='){
-                            a_state = S_START;
-                            token->type = TOKEN_GREAT_EQ;
-                            vector_dispose(buffer);
-                            return token;
-                        } else {
-                            ungetc(next_char, stdin);
-                        }
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '<'){
-                        token->type = TOKEN_LESS;
-
-                        if((next_char = (char) getc(stdin)) == '='){
-                            a_state = S_START;
-                            token->type = TOKEN_LESS_EQ;
-                            vector_dispose(buffer);
-                            return token;
-                        } else {
-                            ungetc(next_char, stdin);
-                        }
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '='){
-                        token->type = TOKEN_EQ;
-
-                        if((next_char = (char) getc(stdin)) == '='){
-                            a_state = S_START;
-                            token->type = TOKEN_EQEQ;
-                            vector_dispose(buffer);
-                            return token;
-                        } else {
-                            ungetc(next_char, stdin);
-                        }
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '!'){
-                        token->type = TOKEN_EXCLAM;
-
-                        if((next_char = (char) getc(stdin)) == '='){
-                            a_state = S_START;
-
-                            token->type = TOKEN_EXCLAMEQ;
-                            vector_dispose(buffer);
-                             return token;
-                        } else {
-                            ungetc(next_char, stdin);
-                        }
-                        vector_dispose(buffer);
-                        return token;    
-
-                    } else if(readchar == '*'){
-                        a_state = S_START;
-                        token->type = TOKEN_MULTIPLY;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == '+'){
-                        a_state = S_START;
-                        token->type = TOKEN_PLUS;
-                        vector_dispose(buffer);
-                        return token;
-                    
-                    } else if(readchar == '/'){
-                        next_char = (char) getc(stdin);
-                        if(next_char == '*'){
-                            cnt_open++;
-                            a_state = S_NESTED_COM;
-                            break;
-                        } else if(next_char == '/'){
-                            a_state = S_SL_COM;
-                            break;
-                        } else {
-                            ungetc(next_char, stdin);
-                            token->type = TOKEN_DIVIDE;
-                            vector_dispose(buffer);
-                            return token;
-                        }
-                    } else if(readchar == '_'){
-                        a_state = S_START;
-                        token->type = TOKEN_UNDERSCORE;
-                        vector_append(buffer, readchar);
-                        token->value.vector = buffer;
-
-                        if((next_char = (char) getc(stdin)) == '_' || isalpha(next_char) || isdigit(next_char)){
-                            a_state = S_ID;
-                            vector_append(buffer, readchar);
-                            vector_append(buffer, next_char);
-                            break;
-                        } else {
-                            ungetc(next_char, stdin);
-                        }
-                        return token;     
-
-                    } else if(readchar == '-'){
-                        token->type = TOKEN_MINUS;
-
-                        if((next_char = (char) getc(stdin)) == '>'){
-                            a_state = S_START;
-
-                            token->type = TOKEN_RET_TYPE;
-                            vector_dispose(buffer);
-                            return token;
-                        } else {
-                            ungetc(next_char, stdin);
-                        }
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(readchar == ' '){
-                        //whitespaces are ignored
-                        continue;
-                        
-                    } else if(readchar == '\t'){
-                        //tabs are ignored
-                        continue;
-                        
-                    } else if(readchar == '\n'){
-                        token->type = TOKEN_EOL;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if((int)readchar == EOF){
-                        token->type = TOKEN_EOF;
-                        vector_dispose(buffer);
-                        return token;
-
-                    } else if(isalpha(readchar)){
-                        a_state = S_ID;
-                        vector_append(buffer, readchar);
-                        break;
-                    } else if(isdigit(readchar)){
-                        a_state = S_NUM;
-                        vector_append(buffer, readchar);
-                        break;
-                    } else if(readchar == '"'){
-                        next_char = (char) getc(stdin);
-                        if(next_char == '"'){
-                            a_state = S_STR_EMPTY;
-                            break;
-                        } else {
-                            ungetc(next_char, stdin);
-                            a_state = S_START_QUOTES;
-                            break;
-                        }
-                    }
+        while(*source.cursor != '\n'){
+            const char* run = source.cursor;
+            source.cursor = simd_skip_string(source.cursor, indent);
+            vector_append_n(buffer, run, source.cursor - run);
 
-            case(S_QM):
-                if((next_char = (char) getc(stdin)) == '?'){
-                    a_state = S_START;
-                    token->type = TOKEN_DOUBLE_QM;
-                    return token;
-                } else {
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Single questionmark is not valid token");
-                }
-            case(S_ID):
-                if(isalpha(readchar) || isdigit(readchar) || readchar == '_'){
-                    vector_append(buffer, readchar);
-                    break;
+            char readchar = *source.cursor;
+            if(readchar == '\n'){
+                break;
+            }
+            source.cursor++;
+            if(readchar == '\\'){
+                scan_escape(buffer);
+            } else {
+                vector_append(buffer, readchar);
+            }
+        }
+        source.cursor++;
+    }
 
-                } else if(readchar == '?'){
-                    keyword_t key = compare_keyword(buffer);
-                    //QM types are only int, double and string
-                    if(key < 3){
-                        vector_append(buffer, readchar);
-                        token->type = TOKEN_KEYWORD_QM;
-                        token->value.keyword = key;
-                        token->value.vector = buffer;
-                        return token;
-                    //It is not QM type so it must be just a keyword
-                    } else if (key > 3 && key != DEFAULT_TOKEN_VAL){
-                        ungetc(readchar, stdin);
-                        a_state = S_QM;
-                        token->type = TOKEN_KEYWORD;
-                        token->value.keyword = key;
-                        token->value.vector = buffer;
-                        return token;
-                    //no match so it is just id
-                    } else  {
-                        ungetc(readchar, stdin);
-                        a_state = S_QM;
-                        token->type = TOKEN_ID;
-                        token->value.vector = buffer;
-                        return token;
-                    }
-                } else {
-                    ungetc(readchar, stdin);
-                    keyword_t key = compare_keyword(buffer);
-                    if(key != DEFAULT_TOKEN_VAL){
-                        token->type = TOKEN_KEYWORD;
-                        token->value.keyword = key;
-                        token->value.vector = buffer;
-                        return token;
-                    } else {
-                        token->type = TOKEN_ID;
-                        token->value.vector = buffer;
-                        return token;
-                    }
-                }
-            
-            case(S_NUM):
-                if(isdigit(readchar)){
-                    vector_append(buffer, readchar);
-                    break;
-                } else if(readchar == '.'){
-                    vector_append(buffer, readchar);
-                    a_state = S_NUM_DOT;
-                    break;
-                } else if(readchar == 'e' || readchar == 'E'){
-                    vector_append(buffer, readchar);
-                    a_state = S_NUM_E;
-                    break;
-                } else {
-                    ungetc(readchar, stdin);
-                    token->type = TOKEN_NUM;
-                    if(sscanf(buffer->array, "%d", &token->value.integer) != EOF){
-                        vector_dispose(buffer);
-                        return token;
-                    } else {
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Invalid num value");
-                    }
-                }
+    source.cursor = closing + 3;
+    if(source.cursor < source.end && *source.cursor == '"'){
+        lex_error("Wrong ending of ML Lexical error");
+    }
 
-            case(S_NUM_DOT):
-                if(isdigit(readchar)){
-                    vector_append(buffer, readchar);
-                    a_state = S_DEC;
-                    break;
-                } else {
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Numbers have to follow afte dot");
-                }
-            
-            case(S_DEC):
-                if(isdigit(readchar)){
-                    vector_append(buffer, readchar);
-                    break;
-                } else if(readchar == 'e' || readchar == 'E'){
-                    vector_append(buffer, readchar);
-                    a_state = S_NUM_E;
-                    break;
-                } else {
-                    ungetc(readchar, stdin);
-                    token->type = TOKEN_DEC;
-                    if(sscanf(buffer->array, "%lf", &token->value.type_double) != EOF){
-                        vector_dispose(buffer);
-                        return token;
-                    } else {
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Invalid dec value");
-                    }
+    token->type = TOKEN_ML_STRING;
+    token->value.lexeme = token_arena_string(buffer->array, buffer->size);
+    token->value.length = buffer->size;
+}
+
+//Finishes the token accepted by the automaton
+static token_t* finish_token(token_t* token, const char* start){
+    token_slice(token, start);
+
+    switch(token->type){
+        case TOKEN_ID: {
+            keyword_t key = compare_keyword(start, token->value.length);
+            char next_char = source_getc();
+            if(next_char == '?'){
+                //QM types are only int, double and string
+                if(key < 3){
+                    token->type = TOKEN_KEYWORD_QM;
+                    token->value.keyword = key;
+                    token_slice(token, start);
+                //It is not QM type so it must be just a keyword
+                } else if(key > 3 && key != DEFAULT_TOKEN_VAL){
+                    source_ungetc(next_char);
+                    token->type = TOKEN_KEYWORD;
+                    token->value.keyword = key;
                 }
-            case(S_NUM_E):
-                if(isdigit(readchar)){
-                    vector_append(buffer, readchar);
-                    a_state = S_EXP;
-                    break;
-                } else if(readchar == '+' || readchar == '-'){
-                    vector_append(buffer, readchar);
-                    a_state = S_NUM_E_SIGN;
-                    break;
-                } else {
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Exponent has to be signed or unsigned digit");
+                //no match so it is just id
+                else {
+                    source_ungetc(next_char);
                 }
-            case(S_NUM_E_SIGN):
-                if(isdigit(readchar)){
-                    vector_append(buffer, readchar);
-                    a_state = S_EXP;
-                    break; 
-                } else {
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Exponent has to be digit");
+            } else {
+                source_ungetc(next_char);
+                if(key != DEFAULT_TOKEN_VAL){
+                    token->type = TOKEN_KEYWORD;
+                    token->value.keyword = key;
                 }
-            case(S_EXP):
-                if(isdigit(readchar)){
-                    vector_append(buffer, readchar);
-                    break;
-                } else {
-                    ungetc(readchar, stdin);
-                    token->type = TOKEN_EXP;
-                    if(sscanf(buffer->array, "%lf", &token->value.type_double) != EOF){
-                        vector_dispose(buffer);
-                        return token;
-                    } else {
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Invalid exp value");
-                    }
+            }
+            token->value.name = names_deferred ? NULL : intern(start, token->value.length);
+            return token;
+        }
 
-                }
+        case TOKEN_UNDERSCORE:
+            token->value.name = names_deferred ? NULL : intern(start, token->value.length);
+            return token;
+
+        case TOKEN_NUM:
+            token->value.integer = parse_integer(start, token->value.length);
+            return token;
+
+        case TOKEN_DEC:
+        case TOKEN_EXP:
+            token->value.type_double = parse_double(start, token->value.length);
+            return token;
+
+        default:
+            return token;
+    }
+}
+
+//Scans the rest of string or comment the automaton handed over, returns false for comments that produce no token
+static bool scan_by_hand(token_t* token, automat_state_t a_state){
+    //The lexeme of strings is read into reused buffer
+    if(lexeme == NULL){
+        lexeme = vector_init();
+    } else {
+        vector_clear(lexeme);
+    }
+    vector* buffer = lexeme;
+
+    char readchar, next_char; //current read char and next one
+    int cnt_open = 1; //counter for openings of multiline comments, the automaton has read the first one
+    int cnt_close = 0; //counter for endings of multiline comments
+    const char* start = NULL; //Beginning of the string in the source code
+    bool materialised = false; //Bool value if string is copied into buffer because it had to be transformed
+
+    if(a_state == S_START_QUOTES){
+        //Second quote right after the first one starts empty or multiline string
+        next_char = source_getc();
+        if(next_char == '"'){
+            a_state = S_STR_EMPTY;
+        } else {
+            source_ungetc(next_char);
+            start = source.cursor;
+        }
+    }
+
+    while(true){
+        readchar = source_getc();
+
+        switch(a_state)
+        {
             case(S_START_QUOTES):
-                if(readchar > ASCII_BEGIN && readchar != '\n' && readchar != '\\' && readchar != '"'){
-                    if(readchar == ' '){
-                        vector_str_append(buffer, "\\032");
-                        break;
-                    } else if (readchar == '#'){
-                        vector_str_append(buffer,"\\035");
-                        break;
-                    }else {
-                        vector_append(buffer, readchar);
-                        break;
+                if((unsigned char) readchar > ASCII_BEGIN && (int) readchar != EOF && readchar != '\\' && readchar != '"'){
+                    //The rest of the run of plain characters is skipped at once
+                    const char* run = source.cursor - 1;
+                    source.cursor = simd_skip_string(source.cursor, source.end);
+                    if(materialised){
+                        vector_append_n(buffer, run, source.cursor - run);
                     }
-                    
+                    break;
                 } else if(readchar == '"'){
-                    a_state = S_END_QUOTES;
                     token->type = TOKEN_STRING;
-                    token->value.vector = buffer;
-                    return token;
-                } else if(readchar == '\\'){
-                    a_state = S_START_ESC_SENTENCE;
-                    break;
-                } else {
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Invalid character in string");
-                }
-            case(S_START_ESC_SENTENCE):
-                if(readchar == '"' || readchar == '\\'){
-                    if(is_multiline){
-                        a_state = S_IS_MULTILINE;
-                    } else {
-                        a_state= S_START_QUOTES;
-                    } 
-
-                    if(readchar == '"'){
-                        vector_str_append(buffer, "\\034");
-                    } else if (readchar == '\\'){
-                        vector_str_append(buffer,"\\092");
-                    } 
-                    
-                    break;
-                } else if(readchar == 'n'){
-                    if(is_multiline){
-                        a_state = S_IS_MULTILINE;
-                    } else {
-                        a_state= S_START_QUOTES;
-                    } 
-                    vector_str_append(buffer, "\\010");
-                    break;
-                } else if(readchar == 't'){
-                    if(is_multiline){
-                        a_state = S_IS_MULTILINE;
-                    } else {
-                        a_state= S_START_QUOTES;
-                    } 
-                    vector_str_append(buffer, "\\009");
-                    break;
-                } else if(readchar == 'r'){
-                    int buffer_size = vector_size(buffer);
-                    if(buffer_size == 0){
-                    if(is_multiline){
-                        a_state = S_IS_MULTILINE;
+                    if(materialised){
+                        token->value.lexeme = token_arena_string(buffer->array, buffer->size);
+                        token->value.length = buffer->size;
                     } else {
-                        a_state= S_START_QUOTES;
-                    } 
-                    vector_str_append(buffer, "\\013");
-                        break;
-                    } else if(buffer_size != 0){
-                        next_char = (char) getc(stdin);
-                        if(next_char == '"'){
-                            ungetc(next_char, stdin);
-                            if(is_multiline){
-                                a_state = S_IS_MULTILINE;
-                            } else {
-                                a_state= S_START_QUOTES;
-                            } 
-                            break;
-                        } else {
-                            ungetc(next_char, stdin);
-                            if(is_multiline){
-                                a_state = S_IS_MULTILINE;
-                            } else {
-                                a_state= S_START_QUOTES;
-                            } 
-                            vector_append(buffer, '\n');
-                            break;
-                        }
+                        token->value.lexeme = start;
+                        token->value.length = source.cursor - 1 - start;
                     }
-                } else if(readchar == 'u'){
-                    a_state = S_START_HEX;
-                    break;
-                } else {
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Wrong escape sequence letter");
-                }
-            case(S_START_HEX):
-                if(readchar == '{'){
-                    a_state = S_LEFT_BRACKET;
+                    return true;
+                } else if(readchar == '\\'){
+                    materialise_string(buffer, start, &materialised);
+                    scan_escape(buffer);
                     break;
                 } else {
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Wrong hex format '\\u{dd}'");
+                    lex_error("Invalid character in string");
                 }
-            case(S_LEFT_BRACKET):
-                if(isdigit(readchar) || isalpha(readchar)){
-
-                    if((readchar >= 'A' && readchar <= 'F') || (readchar >= 'a' && readchar <= 'f') || (readchar >= '0' && readchar <= '9')){
-                        hex[hex_counter] = readchar;
-                        hex_counter++;
-                        a_state = S_FIRST_HEX;
-                        break;
-                    } else {
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Hex value has to be in hexadecimal format"); 
-                    }
-
-                } else {
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Hex value has to be in hexadecimal format");
-                }
-            case(S_FIRST_HEX):
-                if(isdigit(readchar) || isalpha(readchar)){
-
-                    if((readchar >= 'A' && readchar <= 'F') || (readchar >= 'a' && readchar <= 'f') || (readchar >= '0' && readchar <= '9')){
-                        
-                        //Too many hex characters
-                        if(hex_counter == 8){
-                            vector_dispose(buffer);
-                            free(token);
-                            token = NULL;
-                            error_exit(ERROR_LEX, "SCANNER", "Hex value has to be in hexadecimal format");
-                        }
-                        hex[hex_counter] = readchar;
-                        hex_counter++;
-                        a_state = S_FIRST_HEX;
-                        break;
-
-                    } else {
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Hex value has to be in hexadecimal format"); 
-                    }
-                } else if(readchar == '}'){
-
-                    non_null_cnt = 0;
-                    for(int i = 0; i < strlen(hex); i++){
-                        //finding values in hexadecimal numbers that are not zero
-                        if(hex[i] != '0'){
-                            non_null_cnt++;
-                        }
-                    }
-                    //if there are more than 2 characters not null, the number is too big and therefore not valid
-                    if(non_null_cnt > 2){
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Hex value has more than 2 digits");
-                    }
-
-                    int hex_num = 0;
-                    if(sscanf(hex, "%x", &hex_num) != EOF){
-                        char* c = (char*) &hex_num;
-                        vector_append(buffer, c[0]);
-                        hex_counter = 0;
-                        for(int i = 0; i < 8; i++){
-                            hex[i] = 0;
-                        }
-                        if(is_multiline){
-                            a_state = S_IS_MULTILINE;
-                        } else {
-                            a_state = S_START_QUOTES;
-                        }
-                        break;
-                    } else {
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Invalid hex value");
-                    }
-
-                } else {
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Wrong hex format '\\u{dd}'");
-                }
-            
             case(S_SL_COM):
                 if(readchar == '\n'){
-                    a_state = S_START;
-                    break;
+                    return false;
                 } else if((int) readchar == EOF){
-                    a_state = S_START;
-                    break;
+                    return false;
                 } else {
+                    source.cursor = simd_skip_line_comment(source.cursor, source.end);
                     break;
                 }
             case(S_NESTED_COM):
 
                 if(((int) readchar == EOF) && (cnt_open != cnt_close)){
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Opening and closing comment symbols do not match");
+                    lex_error("Opening and closing comment symbols do not match");
                 }
 
                 if(readchar == '/'){
-                    next_char = (char) getc (stdin);
+                    next_char = source_getc();
                     if(next_char == '*'){
                         cnt_open++;
                         break;
                     } else {
-                        ungetc(next_char, stdin);
+                        source_ungetc(next_char);
                         break;
                     }
                 } else if(readchar == '*'){
-                    next_char = (char) getc (stdin);
+                    next_char = source_getc();
                     if(next_char == '/'){
                         a_state = S_NESTED_END;
                         cnt_close++;
                         break;
                     } else {
-                        ungetc(next_char, stdin);
+                        source_ungetc(next_char);
                         break;
                     }
                 } else {
+                    source.cursor = simd_skip_nested_comment(source.cursor, source.end);
                     break;
                 }
 
             case(S_NESTED_END):
                 if(cnt_open == cnt_close){
-                    a_state = S_START;
-                    break;
+                    return false;
                 } else if(readchar == '*'){
-                    next_char = (char) getc (stdin);
+                    next_char = source_getc();
                     if(next_char == '/'){
                         cnt_close++;
                         break;
                     } else {
-                        ungetc(next_char, stdin);
+                        source_ungetc(next_char);
                         a_state = S_NESTED_COM;
                         break;
                     }
@@ -777,251 +614,137 @@ token_t* get_me_token(){
                 }
             case(S_STR_EMPTY):
                 if(readchar != '"'){
-                    ungetc(readchar, stdin);
-                    a_state = S_START;
+                    source_ungetc(readchar);
                     token->type = TOKEN_STRING;
-                    token->value.vector = buffer;
-                    return token;
+                    token_slice(token, source.cursor);
+                    return true;
                 } else {
-                    next_char = (char) getc(stdin);
+                    next_char = source_getc();
                     if(next_char == '\n'){
-                        a_state = S_START_MULTILINE;
-                        is_multiline = true;
-                        cnt_array = allocate_memory(8*sizeof(int));
-                        for(int i =0; i < 8; i++){
-                            cnt_array[i] = 0;
-                        }
-                        break;
+                        scan_multiline_string(token, buffer);
+                        return true;
                     } else {
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "Incorrect number of quotes");
+                    lex_error("Incorrect number of quotes");
                     }
                 }
 
-            case(S_START_MULTILINE):
-                //Realloc the counter array if needed
-                if(cnt_array_size + 1 == cnt_array_alloc_size){
-                    int *new_vec = realloc(cnt_array, cnt_array_alloc_size * 2 * sizeof(int));
-                    if(!(new_vec)){
-                        return false;
-                    }
-                    cnt_array = new_vec;
-                    cnt_array_alloc_size *= 2;
-                    for(int i = cnt_array_size +1; i < cnt_array_alloc_size; i++){
-                        cnt_array[i] = 0;
-                    }
-                }
-
-                if(readchar == ' '){
-                    cnt_array[cnt_array_size]++;
-                    vector_str_append(buffer, "\\032");
-                    only_whitespace = true;
-                    break;
-                } else if(readchar == '"'){
-                    only_whitespace = false;
-                    vector_append(buffer, readchar);
-                    next_char = (char) getc (stdin);
-                    if(next_char == '"'){
-                        vector_append(buffer, next_char);
-                        a_state = S_END_MULTILINE;
-                        break;
-                    } else {
-                        free(cnt_array);
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "Lexical error");
-                    }
-                } else if ((int) readchar == EOF) {
-                    only_whitespace = false;
-                    free(cnt_array);
-                    vector_dispose(buffer);
-                    free(token);
-                    token = NULL;
-                    error_exit(ERROR_LEX, "SCANNER", "EOF Lexical error");
-                } else if(readchar == '\\'){
-                    only_whitespace = false;
-                    a_state = S_START_ESC_SENTENCE;
-                    break;
-                } else if(readchar == '\n'){
-                    vector_str_append(buffer, "\\010");
-                    next_char = (char) getc (stdin);
-                    if(next_char == '"'){
-                        ungetc(next_char, stdin);
-                        vector_str_append(buffer, "\\010");
-                        a_state = S_START_MULTILINE;
-                        break;
-                    } else if(next_char == ' ' && only_whitespace == false){
-                        ungetc(next_char, stdin);
-                        a_state = S_START_MULTILINE;
-                        break;
-                    } else if(next_char == ' ' && only_whitespace == true){
-                        ungetc(next_char, stdin);
-                        a_state = S_START_MULTILINE;
-                        cnt_array_size++;
-                        break;
-                    } else if(next_char == '\n'){
-                        vector_str_append(buffer, "\\010");
-                        a_state = S_START_MULTILINE;
-                        break;
-                    } else {
-                        ungetc(next_char, stdin);
-                        a_state = S_IS_MULTILINE;
-                        break;
-                    }
-                } else {
-                    a_state = S_IS_MULTILINE;
-                    only_whitespace = false;
-                    vector_append(buffer, readchar);
-                    break;
-                }
+            default:
+                return false;
+        }
+    }
+}
 
-            case(S_IS_MULTILINE):
+//Scans next token into the token initialized as EOF
+static void scan_token(token_t* token){
+    while(true){
+        automat_state_t state = S_START;
+        const char* start = source.cursor; //Beginning of the lexeme in the source code
+        char readchar;
 
-                if(readchar == '\n'){
-                    vector_str_append(buffer,"\\010");
-                    a_state = S_START_MULTILINE;
-                    cnt_array_size++;
-                    break;
-                } else if(readchar == '"'){
-                    vector_append(buffer, readchar);
-                    next_char = (char) getc (stdin);
-                    if(next_char == '"'){
-                        next_char = (char) getc (stdin);
-                        if(next_char == '"'){
-                            free(cnt_array);
-                            vector_dispose(buffer);
-                            free(token);
-                            token = NULL;
-                            error_exit(ERROR_LEX, "SCANNER", "Wrong ending of ML Lexical error");
-                        } else {
-                            ungetc(next_char, stdin);
-                            a_state = S_START_MULTILINE;
-                            break;
-                        }
-                    } else {
-                        vector_append(buffer, readchar);
-                        a_state = S_IS_MULTILINE;
-                        break;
-                    }
-                } else if(readchar == '\\'){
-                    a_state = S_START_ESC_SENTENCE;
-                    break;
-                } else if(readchar == ' '){
-                    vector_str_append(buffer, "\\032");
-                    break;
-                } else {
-                    vector_append(buffer, readchar);
-                    break;
-                }
+        //Runs of whitespaces are skipped at once
+        if(source.cursor < source.end && (*source.cursor == ' ' || *source.cursor == '\t')){
+            source.cursor = simd_skip_blanks(source.cursor, source.end);
+        }
 
-            case(S_END_MULTILINE):
-                if(readchar == '"'){
-                    next_char = (char) getc(stdin);
-                    if(next_char == '"'){
-                        free(cnt_array);
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "ML Lexical error");
-                    } else {
-                        ungetc(next_char, stdin);
-                        //check if indentation is correct
-                        if(check_indent(cnt_array, cnt_array_size)){
-                            //Replaces " with string ending
-                            buffer->array[buffer->size-1] = '\0';
-                            buffer->array[buffer->size-2] = '\0';
-
-                            buffer->size--;
-                            buffer->size--;
-                            //counts whitespaces in last line
-                            int whitespace_end_cnt = 0; 
-                            for(int i = 0; i < cnt_array[cnt_array_size]; i++){
-                                whitespace_end_cnt++;
-                            }
-                            //whitespace_end_cnt++; //+1 for EOL
-                            for(int i = 0; i < whitespace_end_cnt; i++){
-                                
-                                for(int j = 1; j < 5; j++){
-                                    //removes whitespaces before """ and last EOL
-                                    buffer->array[buffer->size-j-i*4] = '\0';
-                                }
-                            }
-
-                            a_state = S_START;
-                            token->type = TOKEN_ML_STRING;
-                            //cuts indent of ML string with specific number of whitespaces
-                            cut_indent(buffer, whitespace_end_cnt, cnt_array_size);
-                            token->value.vector = buffer;
-                            free(cnt_array);
-                            is_multiline=false;
-                            return token;
-                        } else {
-                            free(cnt_array);
-                            vector_dispose(buffer);
-                            free(token);
-                            token = NULL;
-                            error_exit(ERROR_LEX, "SCANNER", "INDENT ML Lexical error");
-                        }
-                    }
-                } else if(readchar == '\n'){
-                    a_state = S_START_MULTILINE;
-                    cnt_array_size++;
-                    break;
-                } else {
-                    a_state = S_IS_MULTILINE;
-                    vector_append(buffer, readchar);
-                    break;
-                }
-            
-            case(S_FAKE_END_MULTILINE):
-                if(readchar == '"'){
-
-                            if(check_indent(cnt_array, cnt_array_size)){
-                                buffer->array[buffer->size-1] = '\0';
-                                buffer->array[buffer->size-2] = '\0';
-                                buffer->size--;
-                                buffer->size--;
-                                a_state = S_START;
-                                token->type = TOKEN_ML_STRING;
-                                token->value.vector = buffer;
-                                free(cnt_array);
-                                is_multiline=false;
-                                return token;
-                            } else {
-                                free(cnt_array);
-                                vector_dispose(buffer);
-                                free(token);
-                                token = NULL;
-                                error_exit(ERROR_LEX, "SCANNER", "INDENT ML Lexical error");
-                            }
-
-                        free(cnt_array);
-                        vector_dispose(buffer);
-                        free(token);
-                        token = NULL;
-                        error_exit(ERROR_LEX, "SCANNER", "FAKE END ML Lexical error");
-
-                } else if(readchar == '\n'){
-                    a_state = S_START_MULTILINE;
-                    cnt_array_size++;
-                    vector_str_append(buffer, "\\010");
-                    break;
-                } else {
-                    a_state = S_IS_MULTILINE;
-                    vector_append(buffer, readchar);
-                    break;
-                }                
-            default:
-                if((int) readchar == EOF){
-                token->type = TOKEN_EOF;
-                vector_dispose(buffer);
-                return token;
+        //Walk the generated automaton until there is no transition for the read character
+        while(true){
+            readchar = source_getc();
+            automat_state_t next = transition_table[state][char_class[(unsigned char) readchar]];
+            if(next == S_NONE){
+                break;
+            }
+            if(state == S_START){
+                start = source.cursor - 1;
             }
+            state = next;
+        }
+        source_ungetc(readchar);
+
+        if(accept_table[state] >= 0){
+            token->type = accept_table[state];
+            finish_token(token, start);
+            return;
+        }
+        if(error_table[state] != NULL){
+            lex_error(error_table[state]);
+        }
+
+        //Strings and comments continue by hand, after comment the automaton starts again
+        if(scan_by_hand(token, state)){
+            return;
+        }
+    }
+}
 
+token_t* get_me_token(){
+    //Tokens scanned in advance are handed out first, then the scanning continues behind them
+    if(prelexed.next < prelexed.count){
+        //Tokens scanned behind the last one are newer than its lexeme, the adopted chunks can be released then
+        if(prelexed.next + 1 == prelexed.count){
+            token_arena_release_adopted();
         }
+        return &prelexed.tokens[prelexed.next++];
+    }
+
+    //Tokens scanned by the scanner thread come next, the pipe stops when it runs into the end or an error
+    token_t* piped = token_pipe_pop();
+    if(piped != NULL){
+        return piped;
     }
-    return NULL;
+
+    //Token inicialization, the token lives in the arena
+    token_t* token = token_arena_token(TOKEN_EOF);
+    scan_token(token);
+    return token;
+}
+
+void scan_range(token_stream_t* stream, const source_t* code, const char* from, const char* limit){
+    jmp_buf jump;
+
+    source = *code;
+    source.cursor = from;
+    names_deferred = true;
+    stream->failed = false;
+
+    recovery = &jump;
+    if(setjmp(jump) != 0){
+        //The token with the error is not in the stream, exit is where its scanning started
+        stream->failed = true;
+        recovery = NULL;
+        names_deferred = false;
+        return;
+    }
+
+    while(true){
+        stream->exit = source.cursor;
+        if(source.cursor >= limit && limit != source.end){
+            break;
+        }
+        if(stream->count == stream->capacity){
+            stream->capacity = stream->capacity ? 2 * stream->capacity : 1024;
+            stream->tokens = (token_t*) reallocate_memory(stream->tokens, stream->capacity * sizeof(token_t));
+            stream->starts = (const char**) reallocate_memory(stream->starts, stream->capacity * sizeof(const char*));
+        }
+
+        token_t* token = &stream->tokens[stream->count];
+        memset(token, 0, sizeof(token_t));
+        token->type = TOKEN_EOF;
+        token->value.keyword = DEFAULT_TOKEN_VAL;
+        scan_token(token);
+        stream->starts[stream->count++] = stream->exit;
+
+        if(token->type == TOKEN_EOF){
+            stream->exit = source.end;
+            break;
+        }
+    }
+    recovery = NULL;
+    names_deferred = false;
+}
+
+void scanner_use_tokens(token_t* tokens, size_t count, const char* resume){
+    prelexed.tokens = tokens;
+    prelexed.count = count;
+    prelexed.next = 0;
+    source.cursor = resume;
 }
@@ -99,23 +99,23 @@ typedef enum state{
     S_EXP,
 
     S_START_QUOTES, 
-    S_END_QUOTES,    
-    S_START_ESC_SENTENCE, 
-    S_START_HEX, 
-    S_LEFT_BRACKET,
-    S_FIRST_HEX, 
 
     S_THREE_QUOTES,
-    S_START_MULTILINE, 
 
     S_SL_COM,
     S_NESTED_COM,
     S_NESTED_END,
 
     S_STR_EMPTY,
-    S_IS_MULTILINE,
-    S_END_MULTILINE,
-    S_FAKE_END_MULTILINE
+
+    S_LEFT_BRACE,
+    S_RIGHT_BRACE,
+    S_SLASH,
+    S_EOL,
+    S_EOF,
+
+    S_NONE, //No transition, the lexeme ends before the current character
+    S_COUNT //Number of states, size of the transition table
 
 } automat_state_t;
 
@@ -160,10 +160,12 @@ typedef enum expression_type{
 
 /// @brief Struct of data types 
 typedef struct token_value {
-    int integer;
+    long long integer; //int of IFJcode23 has 64 bits
     double type_double;
     keyword_t keyword;
-    vector* vector;
+    const char* lexeme; //view into the source code, or into the token arena for transformed strings
+    int length; //length of the lexeme, it is not null terminated when it points into the source code
+    char* name; //interned name of identifiers, keywords and underscore
 } value_type_t;
 
 /// @brief Struct of token
@@ -176,45 +178,87 @@ typedef struct token {
     bool was_exp;
 } token_t;
 
+/// @brief Struct of the source code buffer the scanner runs over
+typedef struct source_buffer {
+    char* data; //beginning of the source code
+    char* end; //first byte behind the source code, or its first byte which is not valid UTF-8
+    char* data_end; //first byte behind the loaded data
+    const char* cursor; //next character to be read
+    bool mapped; //true if the data are mapped from a file, false if they were read into heap
+} source_t;
+
+extern _Thread_local source_t source; //Source code the scanner of this thread runs over
+
+/// @brief Struct of tokens scanned from a part of the source code
+typedef struct token_stream {
+    token_t* tokens;
+    const char** starts; //position the scanning of every token started at, before the skipped whitespaces and comments
+    size_t count;
+    size_t capacity;
+    const char* exit; //position the scanning of the next token starts at
+    bool failed; //true if lexical error stopped the scanning at exit
+} token_stream_t;
+
 /**
- * @brief Function checks if the token is whether a keyword or an identifier
- * 
- * @param v string value of token 
- * @return keyword_t type of token 
+ * @brief Function loads the whole source code from stdin into one contiguous buffer
+ *
+ * @note stdin is mapped into memory if it is a regular file, otherwise it is read at once
 */
-keyword_t compare_keyword(vector* v);
+void source_init();
 
 /**
- * @brief Function checks if there is correct indent in multiline string
- * 
- * @param cnt_array array of every line indent in multiline string 
- * @param size indent of multiline end 
- * 
- * @return bool true if indent is correct, false otherwise
+ * @brief Function takes over the buffer with source code, it is used instead of source_init when the code does not come from stdin
+ *
+ * @param data Source code allocated on heap, it is freed by source_dispose
+ * @param size Size of the source code
 */
-bool check_indent(int* cnt_array, int size);
+void source_init_buffer(char* data, size_t size);
 
 /**
- * @brief Function that cuts whitespaces according to indent
- * 
- * @param vector Pointer to vector containing multiline string
- * @param indent Number of whitespaces
- * @param lines Number of lines
- */
-void cut_indent(vector* vector, int indent, int lines);
+ * @brief Function releases the buffer with the source code and the buffer of lexemes
+*/
+void source_dispose();
+
+/**
+ * @brief Function releases the buffer of lexemes of the calling thread
+*/
+void scanner_thread_dispose();
 
 /**
- * @brief Function to delete token and free all the memory it had allocated
+ * @brief Function checks if the token is whether a keyword or an identifier
  * 
- * @param token token to be deleted
+ * @param lexeme beginning of the token in source code
+ * @param length length of the token
+ * @return keyword_t type of token 
 */
-void destroy_token(token_t* token);
+keyword_t compare_keyword(const char* lexeme, int length);
 
 /**
  * @brief Function to get token from source code
  * 
- * @return token_t* pointer to newly allocated token
+ * @return token_t* pointer to new token allocated from the token arena
 */
 token_t* get_me_token();
 
+/**
+ * @brief Function scans tokens into the stream until the scanning of the next token would start at limit or behind it
+ *
+ * @note It can run on any thread, names of the tokens are not interned and their strings live in the token arena of the thread.
+ *       Lexical error only stops the scanning, it is reported when get_me_token scans the token again.
+ * @param stream Stream the tokens are appended to
+ * @param code Source code loaded by source_init
+ * @param from Position the scanning starts at
+ * @param limit First position the scanning of token cannot start at, the end of the source code scans up to EOF
+*/
+void scan_range(token_stream_t* stream, const source_t* code, const char* from, const char* limit);
+
+/**
+ * @brief Function hands over the tokens get_me_token returns next instead of scanning
+ *
+ * @param tokens Tokens in order, they are released by source_dispose
+ * @param count Number of the tokens
+ * @param resume Position the scanning continues at behind the last token
+*/
+void scanner_use_tokens(token_t* tokens, size_t count, const char* resume);
+
 #endif
@@ -0,0 +1,218 @@
+/**
+ * @file scanner_gen.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Generator of the transition table of the scanner, run at build time
+ *
+ * The automaton is specified once by the transitions below. The generator splits all characters
+ * into classes of characters the automaton cannot tell apart and prints scanner_table.h with
+ * the character class table, the dense state x class transition table and the tables of
+ * accepting and error states.
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#include "scanner.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LETTERS "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define DIGITS "0123456789"
+#define EOF_CHAR "\xff" //(char) EOF the scanner returns behind the end of the source code
+
+/// Transition of the automaton on every character of the set
+typedef struct transition {
+    automat_state_t from;
+    const char* chars;
+    automat_state_t to;
+} transition_t;
+
+/// Accepting state and the type of token it produces
+typedef struct accept {
+    automat_state_t state;
+    token_type_t type;
+} accept_t;
+
+/// State which cannot end the lexeme and the message of the lexical error
+typedef struct reject {
+    automat_state_t state;
+    const char* message;
+} reject_t;
+
+//Token automaton, strings and comments continue in the hand written part of the scanner
+static const transition_t transitions[] = {
+    {S_START, " \t", S_START}, //whitespaces are ignored
+    {S_START, "\n", S_EOL},
+    {S_START, EOF_CHAR, S_EOF},
+    {S_START, ":", S_COLON},
+    {S_START, ",", S_COMMA},
+    {S_START, "?", S_QM},
+    {S_START, "(", S_LPAR},
+    {S_START, ")", S_RPAR},
+    {S_START, "{", S_LEFT_BRACE},
+    {S_START, "}", S_RIGHT_BRACE},
+    {S_START, ">", S_GTR},
+    {S_START, "<", S_LESS},
+    {S_START, "=", S_EQ},
+    {S_START, "!", S_EXCLAM},
+    {S_START, "*", S_MULTIPLY},
+    {S_START, "+", S_PLUS},
+    {S_START, "-", S_MINUS},
+    {S_START, "/", S_SLASH},
+    {S_START, "_", S_UNDERSCORE},
+    {S_START, LETTERS, S_ID},
+    {S_START, DIGITS, S_NUM},
+    {S_START, "\"", S_START_QUOTES},
+
+    {S_QM, "?", S_DOUBLE_QM},
+    {S_GTR, "=", S_GTR_EQ},
+    {S_LESS, "=", S_LESS_EQ},
+    {S_EQ, "=", S_EQEQ},
+    {S_EXCLAM, "=", S_EXCLAMEQ},
+    {S_MINUS, ">", S_RET_TYPE},
+    {S_SLASH, "/", S_SL_COM},
+    {S_SLASH, "*", S_NESTED_COM},
+
+    {S_UNDERSCORE, LETTERS DIGITS "_", S_ID},
+    {S_ID, LETTERS DIGITS "_", S_ID},
+
+    {S_NUM, DIGITS, S_NUM},
+    {S_NUM, ".", S_NUM_DOT},
+    {S_NUM, "eE", S_NUM_E},
+    {S_NUM_DOT, DIGITS, S_DEC},
+    {S_DEC, DIGITS, S_DEC},
+    {S_DEC, "eE", S_NUM_E},
+    {S_NUM_E, DIGITS, S_EXP},
+    {S_NUM_E, "+-", S_NUM_E_SIGN},
+    {S_NUM_E_SIGN, DIGITS, S_EXP},
+    {S_EXP, DIGITS, S_EXP},
+};
+
+static const accept_t accepts[] = {
+    {S_COLON, TOKEN_COLON},
+    {S_COMMA, TOKEN_COMMA},
+    {S_DOUBLE_QM, TOKEN_DOUBLE_QM},
+    {S_LPAR, TOKEN_LPAR},
+    {S_RPAR, TOKEN_RPAR},
+    {S_LEFT_BRACE, TOKEN_LEFT_BRACKET},
+    {S_RIGHT_BRACE, TOKEN_RIGHT_BRACKET},
+    {S_GTR, TOKEN_GREAT},
+    {S_GTR_EQ, TOKEN_GREAT_EQ},
+    {S_LESS, TOKEN_LESS},
+    {S_LESS_EQ, TOKEN_LESS_EQ},
+    {S_EQ, TOKEN_EQ},
+    {S_EQEQ, TOKEN_EQEQ},
+    {S_EXCLAM, TOKEN_EXCLAM},
+    {S_EXCLAMEQ, TOKEN_EXCLAMEQ},
+    {S_MULTIPLY, TOKEN_MULTIPLY},
+    {S_PLUS, TOKEN_PLUS},
+    {S_MINUS, TOKEN_MINUS},
+    {S_RET_TYPE, TOKEN_RET_TYPE},
+    {S_SLASH, TOKEN_DIVIDE},
+    {S_UNDERSCORE, TOKEN_UNDERSCORE},
+    {S_ID, TOKEN_ID},
+    {S_NUM, TOKEN_NUM},
+    {S_DEC, TOKEN_DEC},
+    {S_EXP, TOKEN_EXP},
+    {S_EOL, TOKEN_EOL},
+    {S_EOF, TOKEN_EOF},
+};
+
+static const reject_t rejects[] = {
+    {S_START, "Invalid character in source code"},
+    {S_QM, "Single questionmark is not valid token"},
+    {S_NUM_DOT, "Numbers have to follow afte dot"},
+    {S_NUM_E, "Exponent has to be signed or unsigned digit"},
+    {S_NUM_E_SIGN, "Exponent has to be digit"},
+};
+
+#define COUNT(array) (sizeof(array) / sizeof(array[0]))
+
+int main(){
+    static unsigned char table[S_COUNT][256];
+    unsigned char char_class[256];
+    int class_char[256]; //representative character of every class
+    int class_count = 0;
+
+    memset(table, S_NONE, sizeof(table));
+    for(size_t i = 0; i < COUNT(transitions); i++){
+        for(const char* c = transitions[i].chars; *c; c++){
+            table[transitions[i].from][(unsigned char) *c] = transitions[i].to;
+        }
+    }
+
+    //Characters with the same transitions in every state fall into one class
+    for(int c = 0; c < 256; c++){
+        int found = -1;
+        for(int k = 0; k < class_count && found < 0; k++){
+            int same = 1;
+            for(int s = 0; s < S_COUNT && same; s++){
+                same = table[s][c] == table[s][class_char[k]];
+            }
+            if(same){
+                found = k;
+            }
+        }
+        if(found < 0){
+            found = class_count;
+            class_char[class_count++] = c;
+        }
+        char_class[c] = found;
+    }
+
+    printf("/**\n * @file scanner_table.h\n *\n * IFJ23 compiler\n *\n");
+    printf(" * @brief Transition tables of the scanner generated by scanner_gen, do not edit\n */\n\n");
+    printf("#ifndef IFJ_SCANNER_TABLE_H\n#define IFJ_SCANNER_TABLE_H\n\n");
+    printf("#define CHAR_CLASS_COUNT %d //Number of character classes\n\n", class_count);
+
+    printf("//Class of every character\nstatic const unsigned char char_class[256] = {");
+    for(int c = 0; c < 256; c++){
+        printf("%s%d,", c % 16 ? " " : "\n    ", char_class[c]);
+    }
+    printf("\n};\n\n");
+
+    printf("//Next state for every state and character class, S_NONE if the lexeme ends\n");
+    printf("static const unsigned char transition_table[S_COUNT][CHAR_CLASS_COUNT] = {\n");
+    for(int s = 0; s < S_COUNT; s++){
+        printf("    {");
+        for(int k = 0; k < class_count; k++){
+            printf("%s%d", k ? ", " : "", table[s][class_char[k]]);
+        }
+        printf("}, //state %d\n", s);
+    }
+    printf("};\n\n");
+
+    int accept_table[S_COUNT];
+    const char* error_table[S_COUNT];
+    for(int s = 0; s < S_COUNT; s++){
+        accept_table[s] = -1;
+        error_table[s] = NULL;
+    }
+    for(size_t i = 0; i < COUNT(accepts); i++){
+        accept_table[accepts[i].state] = accepts[i].type;
+    }
+    for(size_t i = 0; i < COUNT(rejects); i++){
+        error_table[rejects[i].state] = rejects[i].message;
+    }
+
+    printf("//Type of token produced by accepting states, -1 for the others\n");
+    printf("static const signed char accept_table[S_COUNT] = {");
+    for(int s = 0; s < S_COUNT; s++){
+        printf("%s%d,", s % 16 ? " " : "\n    ", accept_table[s]);
+    }
+    printf("\n};\n\n");
+
+    printf("//Message of the lexical error when the lexeme ends in a state, NULL for the others\n");
+    printf("static const char* const error_table[S_COUNT] = {\n");
+    for(int s = 0; s < S_COUNT; s++){
+        if(error_table[s]){
+            printf("    \"%s\", //state %d\n", error_table[s], s);
+        } else {
+            printf("    NULL, //state %d\n", s);
+        }
+    }
+    printf("};\n\n#endif\n");
+    return 0;
+}
@@ -0,0 +1,498 @@
+/**
+ * @file simd.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Vectorized skipping of whitespaces, comments and string bodies and UTF-8 validation
+ *
+ * Every kernel exists in AVX2 (32 bytes at a time), SSE2 (16 bytes at a time) and scalar version,
+ * the best one supported by the processor is selected on the first call.
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__SSE2__)
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+
+#define EOF_BYTE ((char) EOF) //byte the scanner treats as the end of the source code
+
+// Scalar predicates, true for the character the kernel stops at
+
+static inline bool blank_stop(char c) {
+    return c != ' ' && c != '\t';
+}
+
+static inline bool line_comment_stop(char c) {
+    return c == '\n' || c == EOF_BYTE;
+}
+
+static inline bool nested_comment_stop(char c) {
+    return c == '*' || c == '/' || c == EOF_BYTE;
+}
+
+static inline bool string_stop(char c) {
+    // Control characters are not plain, bytes of UTF-8 sequences are
+    return (unsigned char)c < ' ' || c == '"' || c == '\\' || c == EOF_BYTE;
+}
+
+static inline bool string_constant_stop(char c) {
+    // Everything up to space, '#' and '\' has to be written as escape sequence, other bytes including UTF-8 are not
+    return (unsigned char)c <= ' ' || c == '#' || c == '\\';
+}
+
+#ifdef SIMD_X86
+
+// SSE2 masks, bit i is set if the kernel stops at byte i
+
+static inline unsigned blank_mask_sse2(__m128i v) {
+    __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    return _mm_movemask_epi8(blank) ^ 0xFFFF;
+}
+
+static inline unsigned line_comment_mask_sse2(__m128i v) {
+    __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8(EOF_BYTE)));
+    return _mm_movemask_epi8(stop);
+}
+
+static inline unsigned nested_comment_mask_sse2(__m128i v) {
+    __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('*')), _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+    stop = _mm_or_si128(stop, _mm_cmpeq_epi8(v, _mm_set1_epi8(EOF_BYTE)));
+    return _mm_movemask_epi8(stop);
+}
+
+static inline unsigned string_mask_sse2(__m128i v) {
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8(EOF_BYTE)));
+    // Unsigned v >= ' ' holds exactly when max(v, ' ') == v
+    __m128i plain = _mm_andnot_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(' ')), v));
+    return _mm_movemask_epi8(plain) ^ 0xFFFF;
+}
+
+static inline unsigned string_constant_mask_sse2(__m128i v) {
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('#')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    // Unsigned v <= ' ' holds exactly when max(v, ' ') == ' '
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(' ')), _mm_set1_epi8(' ')));
+    return _mm_movemask_epi8(special);
+}
+
+// AVX2 masks, bit i is set if the kernel stops at byte i
+
+__attribute__((target("avx2")))
+static inline unsigned blank_mask_avx2(__m256i v) {
+    __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+    return ~(unsigned)_mm256_movemask_epi8(blank);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned line_comment_mask_avx2(__m256i v) {
+    __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(EOF_BYTE)));
+    return _mm256_movemask_epi8(stop);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned nested_comment_mask_avx2(__m256i v) {
+    __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('*')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')));
+    stop = _mm256_or_si256(stop, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(EOF_BYTE)));
+    return _mm256_movemask_epi8(stop);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned string_mask_avx2(__m256i v) {
+    __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+    special = _mm256_or_si256(special, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(EOF_BYTE)));
+    __m256i plain = _mm256_andnot_si256(special, _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(' ')), v));
+    return ~(unsigned)_mm256_movemask_epi8(plain);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned string_constant_mask_avx2(__m256i v) {
+    __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('#')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+    special = _mm256_or_si256(special, _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(' ')), _mm256_set1_epi8(' ')));
+    return _mm256_movemask_epi8(special);
+}
+
+// Scalar, SSE2 and AVX2 version of the kernel, the vector versions finish the tail by the narrower one
+#define SIMD_KERNEL(name) \
+    static const char* name##_scalar(const char* p, const char* end) { \
+        while (p < end && !name##_stop(*p)) { \
+            p++; \
+        } \
+        return p; \
+    } \
+    static const char* name##_sse2(const char* p, const char* end) { \
+        while (end - p >= 16) { \
+            unsigned mask = name##_mask_sse2(_mm_loadu_si128((const __m128i*)p)); \
+            if (mask != 0) { \
+                return p + __builtin_ctz(mask); \
+            } \
+            p += 16; \
+        } \
+        return name##_scalar(p, end); \
+    } \
+    __attribute__((target("avx2"))) \
+    static const char* name##_avx2(const char* p, const char* end) { \
+        while (end - p >= 32) { \
+            unsigned mask = name##_mask_avx2(_mm256_loadu_si256((const __m256i*)p)); \
+            if (mask != 0) { \
+                return p + __builtin_ctz(mask); \
+            } \
+            p += 32; \
+        } \
+        return name##_sse2(p, end); \
+    }
+
+#else
+
+// Only the scalar version is available on other architectures
+#define SIMD_KERNEL(name) \
+    static const char* name##_scalar(const char* p, const char* end) { \
+        while (p < end && !name##_stop(*p)) { \
+            p++; \
+        } \
+        return p; \
+    }
+
+#endif
+
+SIMD_KERNEL(blank)
+SIMD_KERNEL(line_comment)
+SIMD_KERNEL(nested_comment)
+SIMD_KERNEL(string)
+SIMD_KERNEL(string_constant)
+
+// UTF-8 validation by lookup of the classes of errors, every pair of bytes is checked by three table lookups
+// (Keiser, Lemire: Validating UTF-8 In Less Than One Instruction Per Byte)
+
+#define UTF8_TOO_SHORT (1 << 0) // lead byte not followed by enough continuations
+#define UTF8_TOO_LONG (1 << 1) // continuation after ASCII
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE (1 << 3) // code point above U+10FFFF
+#define UTF8_SURROGATE (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTS (1 << 7) // two continuations, valid only inside of 3 and 4 byte sequences
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+// Scalar search of the first byte which does not start a valid sequence, end if there is none
+static const unsigned char* utf8_scalar_invalid(const unsigned char* p, const unsigned char* end) {
+    while (p < end) {
+        if (*p < 0x80) {
+            p++;
+            continue;
+        }
+        int length;
+        unsigned code;
+        if ((*p & 0xE0) == 0xC0) {
+            length = 2;
+            code = *p & 0x1F;
+        }
+        else if ((*p & 0xF0) == 0xE0) {
+            length = 3;
+            code = *p & 0x0F;
+        }
+        else if ((*p & 0xF8) == 0xF0) {
+            length = 4;
+            code = *p & 0x07;
+        }
+        else {
+            return p;
+        }
+        if (end - p < length) {
+            return p;
+        }
+        for (int i = 1; i < length; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return p;
+            }
+            code = (code << 6) | (p[i] & 0x3F);
+        }
+        // Overlong encodings, surrogates and code points above U+10FFFF are not valid
+        if ((length == 2 && code < 0x80) || (length == 3 && code < 0x800) || (length == 4 && code < 0x10000) ||
+            (code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF) {
+            return p;
+        }
+        p += length;
+    }
+    return end;
+}
+
+// Scalar validation, also used for the tails of the vector versions
+static bool utf8_scalar(const unsigned char* p, const unsigned char* end) {
+    return utf8_scalar_invalid(p, end) == end;
+}
+
+#ifdef SIMD_X86
+
+// Tables of the error classes by the high and low nibble of the first byte and the high nibble of the second byte
+#define UTF8_BYTE_1_HIGH \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2, \
+    UTF8_TOO_SHORT, \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE, \
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+#define UTF8_BYTE_1_LOW \
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, \
+    UTF8_CARRY | UTF8_OVERLONG_2, \
+    UTF8_CARRY, \
+    UTF8_CARRY, \
+    UTF8_CARRY | UTF8_TOO_LARGE, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+
+#define UTF8_BYTE_2_HIGH \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+// Errors of 16 bytes, prev holds the previous block
+__attribute__((target("ssse3")))
+static inline __m128i utf8_errors_ssse3(__m128i input, __m128i prev) {
+    const __m128i byte_1_high = _mm_setr_epi8(UTF8_BYTE_1_HIGH);
+    const __m128i byte_1_low = _mm_setr_epi8(UTF8_BYTE_1_LOW);
+    const __m128i byte_2_high = _mm_setr_epi8(UTF8_BYTE_2_HIGH);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+
+    __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+    __m128i special = _mm_and_si128(_mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                                    _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble)));
+    special = _mm_and_si128(special, _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+    // Two continuations are valid only as the third or fourth byte of a sequence
+    __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8(0xE0 - 0x80));
+    __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13), _mm_set1_epi8(0xF0 - 0x80));
+    __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(0x80));
+    return _mm_xor_si128(must_be_continuation, special);
+}
+
+// Nonzero if the block ends in the middle of a sequence
+static inline __m128i utf8_incomplete_sse2(__m128i input) {
+    const __m128i max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1);
+    return _mm_subs_epu8(input, max);
+}
+
+__attribute__((target("ssse3")))
+static bool utf8_ssse3(const unsigned char* p, const unsigned char* end) {
+    __m128i error = _mm_setzero_si128();
+    __m128i prev = _mm_setzero_si128();
+    __m128i incomplete = _mm_setzero_si128();
+    unsigned char tail[16];
+
+    while (p < end) {
+        __m128i input;
+        if (end - p >= 16) {
+            input = _mm_loadu_si128((const __m128i*)p);
+        }
+        else {
+            // The tail is padded by ASCII zeros
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, p, end - p);
+            input = _mm_loadu_si128((const __m128i*)tail);
+        }
+        p += 16;
+
+        if (_mm_movemask_epi8(input) == 0) {
+            // Block of ASCII only can be wrong only if the previous block was not finished
+            error = _mm_or_si128(error, incomplete);
+            incomplete = _mm_setzero_si128();
+        }
+        else {
+            error = _mm_or_si128(error, utf8_errors_ssse3(input, prev));
+            incomplete = utf8_incomplete_sse2(input);
+        }
+        prev = input;
+    }
+    error = _mm_or_si128(error, incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+// Errors of 32 bytes, prev holds the previous block
+__attribute__((target("avx2")))
+static inline __m256i utf8_errors_avx2(__m256i input, __m256i prev) {
+    const __m256i byte_1_high = _mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH);
+    const __m256i byte_1_low = _mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW);
+    const __m256i byte_2_high = _mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    // Shifting across the lanes needs the high lane of prev next to the low lane of input
+    __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    __m256i special = _mm256_and_si256(_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                                       _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble)));
+    special = _mm256_and_si256(special, _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+    __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 14), _mm256_set1_epi8(0xE0 - 0x80));
+    __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(0x80));
+    return _mm256_xor_si256(must_be_continuation, special);
+}
+
+__attribute__((target("avx2")))
+static bool utf8_avx2(const unsigned char* p, const unsigned char* end) {
+    const __m256i max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1);
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    unsigned char tail[32];
+
+    while (p < end) {
+        __m256i input;
+        if (end - p >= 32) {
+            input = _mm256_loadu_si256((const __m256i*)p);
+        }
+        else {
+            // The tail is padded by ASCII zeros
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, p, end - p);
+            input = _mm256_loadu_si256((const __m256i*)tail);
+        }
+        p += 32;
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, incomplete);
+            incomplete = _mm256_setzero_si256();
+        }
+        else {
+            error = _mm256_or_si256(error, utf8_errors_avx2(input, prev));
+            incomplete = _mm256_subs_epu8(input, max);
+        }
+        prev = input;
+    }
+    error = _mm256_or_si256(error, incomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+#endif
+
+typedef const char* (*skip_kernel_t)(const char*, const char*);
+
+// Kernels selected for the processor
+static struct skip_kernels {
+    bool selected;
+    skip_kernel_t blank;
+    skip_kernel_t line_comment;
+    skip_kernel_t nested_comment;
+    skip_kernel_t string;
+    skip_kernel_t string_constant;
+    bool (*utf8)(const unsigned char*, const unsigned char*);
+} kernels = {false, NULL, NULL, NULL, NULL, NULL, NULL};
+
+// Select the widest kernels the processor supports
+static void simd_select() {
+    kernels.blank = blank_scalar;
+    kernels.line_comment = line_comment_scalar;
+    kernels.nested_comment = nested_comment_scalar;
+    kernels.string = string_scalar;
+    kernels.string_constant = string_constant_scalar;
+    kernels.utf8 = utf8_scalar;
+
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.blank = blank_avx2;
+        kernels.line_comment = line_comment_avx2;
+        kernels.nested_comment = nested_comment_avx2;
+        kernels.string = string_avx2;
+        kernels.string_constant = string_constant_avx2;
+        kernels.utf8 = utf8_avx2;
+    }
+    else {
+        kernels.blank = blank_sse2;
+        kernels.line_comment = line_comment_sse2;
+        kernels.nested_comment = nested_comment_sse2;
+        kernels.string = string_sse2;
+        kernels.string_constant = string_constant_sse2;
+        if (__builtin_cpu_supports("ssse3")) {
+            kernels.utf8 = utf8_ssse3;
+        }
+    }
+#endif
+
+    kernels.selected = true;
+}
+
+const char* simd_skip_blanks(const char* p, const char* end) {
+    if (!kernels.selected) {
+        simd_select();
+    }
+    return kernels.blank(p, end);
+}
+
+const char* simd_skip_line_comment(const char* p, const char* end) {
+    if (!kernels.selected) {
+        simd_select();
+    }
+    return kernels.line_comment(p, end);
+}
+
+const char* simd_skip_nested_comment(const char* p, const char* end) {
+    if (!kernels.selected) {
+        simd_select();
+    }
+    return kernels.nested_comment(p, end);
+}
+
+const char* simd_skip_string(const char* p, const char* end) {
+    if (!kernels.selected) {
+        simd_select();
+    }
+    return kernels.string(p, end);
+}
+
+const char* simd_skip_string_constant(const char* p, const char* end) {
+    if (!kernels.selected) {
+        simd_select();
+    }
+    return kernels.string_constant(p, end);
+}
+
+const char* simd_find_invalid_utf8(const char* p, const char* end) {
+    if (!kernels.selected) {
+        simd_select();
+    }
+    if (kernels.utf8((const unsigned char*)p, (const unsigned char*)end)) {
+        return end;
+    }
+    // Invalid text is rare, the exact position is found by the scalar version
+    return (const char*)utf8_scalar_invalid((const unsigned char*)p, (const unsigned char*)end);
+}
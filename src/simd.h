@@ -0,0 +1,73 @@
+/**
+ * @file simd.h
+ *
+ * IFJ23 compiler
+ *
+ * @brief Vectorized skipping of whitespaces, comments and string bodies and UTF-8 validation
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#ifndef IFJ_SIMD_H
+#define IFJ_SIMD_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Skip spaces and tabs
+ *
+ * @param p First character to be checked
+ * @param end First character behind the source code
+ * @return const char* First character which is neither space nor tab, end if there is none
+ */
+const char* simd_skip_blanks(const char* p, const char* end);
+
+/**
+ * @brief Skip the body of single line comment
+ *
+ * @param p First character to be checked
+ * @param end First character behind the source code
+ * @return const char* First EOL or (char) EOF byte, end if there is none
+ */
+const char* simd_skip_line_comment(const char* p, const char* end);
+
+/**
+ * @brief Skip the body of nested comment to the next character that can open or close it
+ *
+ * @param p First character to be checked
+ * @param end First character behind the source code
+ * @return const char* First '*', '/' or (char) EOF byte, end if there is none
+ */
+const char* simd_skip_nested_comment(const char* p, const char* end);
+
+/**
+ * @brief Skip characters of string literal which are its value without any change
+ *
+ * @note Printable characters except '"' and '\\' are plain, including bytes of UTF-8 sequences
+ * @param p First character to be checked
+ * @param end First character behind the source code
+ * @return const char* First character which has to be handled by the scanner, end if there is none
+ */
+const char* simd_skip_string(const char* p, const char* end);
+
+/**
+ * @brief Skip characters which can be written into IFJcode23 string constant without escape sequence
+ *
+ * @param p First character to be checked
+ * @param end First character behind the string
+ * @return const char* First character up to space, '#' or '\\', end if there is none
+ */
+const char* simd_skip_string_constant(const char* p, const char* end);
+
+/**
+ * @brief Find the first byte of the text which does not start a valid UTF-8 sequence
+ *
+ * @note Overlong encodings, surrogates and code points above U+10FFFF are not valid
+ * @param p First character of the text
+ * @param end First character behind the text
+ * @return const char* Position of the first invalid sequence, end if the text is valid UTF-8
+ */
+const char* simd_find_invalid_utf8(const char* p, const char* end);
+
+#endif //IFJ_SIMD_H
@@ -11,14 +11,20 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 #include <string.h>
 
@@ -57,6 +63,27 @@ bool vector_str_append(vector* v, char* c){
     return true;
 }
 
+bool vector_append_n(vector* v, const char* s, int length){
+    if(v->size + length >= v->size_of_alloc){
+        int new_alloc = v->size_of_alloc;
+        while(v->size + length >= new_alloc){
+            new_alloc *= 2;
+        }
+        v->array = reallocate_memory(v->array, new_alloc * sizeof(char));
+        v->size_of_alloc = new_alloc;
+    }
+
+    memcpy(v->array + v->size, s, length);
+    v->size += length;
+    v->array[v->size] = '\0';
+    return true;
+}
+
+void vector_clear(vector* v){
+    v->size = 0;
+    v->array[0] = '\0';
+}
+
 void vector_dispose(vector* v){
     v->size = 0;
     v->size_of_alloc = 0;
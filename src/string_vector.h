@@ -45,6 +45,23 @@ bool vector_append(vector* v, char c);
  */
 bool vector_str_append(vector *v, char *s);
 
+/**
+ * @brief Adds length chars of string to the end of the actual vector at once
+ * 
+ * @param v pointer to vector
+ * @param s pointer to chars to be added, they do not have to be null terminated
+ * @param length number of chars to be added
+ * @return true if done correctly, false otherwise 
+ */
+bool vector_append_n(vector *v, const char *s, int length);
+
+/**
+ * @brief Empties the vector, allocated space is kept for reuse
+ * 
+ * @param v pointer to vector
+ */
+void vector_clear(vector *v);
+
 /**
  * @brief Free vector
  * 
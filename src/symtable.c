@@ -12,19 +12,31 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
+#include <stdint.h>
 #include <string.h>
 
 
 
+// Keys are interned, equal names share the address, so the tree is ordered by the addresses
+static inline int key_compare(const char *tree_key, const char *key) {
+    return ((uintptr_t)tree_key > (uintptr_t)key) - ((uintptr_t)tree_key < (uintptr_t)key);
+}
+
 sym_data *data_init(sym_data *data){
     data = (sym_data *)allocate_memory(sizeof(sym_data));
 
@@ -66,30 +78,31 @@ sym_data *set_data_param(data_type param_type, char *param_name, int param_order
     data->defined = true;
     data->is_param = true;
     data->param_type = param_type;
-    data->param_name = (char *)allocate_memory(sizeof(char) * (strlen(param_name) + 2));
-    strcpy(data->param_name, param_name);
+    data->param_name = param_name;
     data->param_order = param_order;
     return data;
 }
 
 
-AVL_tree *symtable_search(AVL_tree *tree, char *key) {
+#ifndef SYMTABLE_HASH
+
+AVL_tree *symtable_search(symtable_t *tree, char *key) {
     if (tree == NULL || key == NULL) {
         return NULL;
     }
-    else if (strcmp(tree->key, key) == 0) {
+    else if (key_compare(tree->key, key) == 0) {
         return tree;
     } 
-    else if (strcmp(tree->key, key) > 0) {
+    else if (key_compare(tree->key, key) > 0) {
         return symtable_search(tree->left, key);
     }
-    else { // strcmp(tree->key, key) < 0
+    else { // key_compare(tree->key, key) < 0
         return symtable_search(tree->right, key);
     }
 }
 
 
-AVL_tree *symtable_find_param(AVL_tree *tree, int order_arg) {
+AVL_tree *symtable_find_param(symtable_t *tree, int order_arg) {
     if (tree == NULL) {
         return NULL;
     }
@@ -158,7 +171,7 @@ void left_rotate(AVL_tree **tree) {
 }
 
 
-void symtable_insert(AVL_tree **tree, char *key, sym_data *data) {
+void symtable_insert(symtable_t **tree, char *key, sym_data *data) {
     if (*tree == NULL) { // insert first to an empty tree
         *tree = (AVL_tree *)allocate_memory(sizeof(AVL_tree));
         (*tree)->key = key;
@@ -168,13 +181,13 @@ void symtable_insert(AVL_tree **tree, char *key, sym_data *data) {
         (*tree)->height = 0;
         (*tree)->nickname = 0;
     }
-    else if (strcmp((*tree)->key, key) > 0) {
+    else if (key_compare((*tree)->key, key) > 0) {
         symtable_insert(&((*tree)->left), key, data);
     }
-    else if (strcmp((*tree)->key, key) < 0) {
+    else if (key_compare((*tree)->key, key) < 0) {
         symtable_insert(&((*tree)->right), key, data);
     }
-    else { // strcmp((*tree)->key, key) == 0
+    else { // key_compare((*tree)->key, key) == 0
         error_exit(ERROR_SEM_UNDEF_FUN, "SYMTABLE", "Key already exists in the symbol table.");
     }
 
@@ -186,20 +199,20 @@ void symtable_insert(AVL_tree **tree, char *key, sym_data *data) {
     if (balance != 0) { // if the tree is not balanced
 
         // LL case
-        if (balance > 1 && strcmp((*tree)->key, key) > 0) {
+        if (balance > 1 && key_compare((*tree)->key, key) > 0) {
             right_rotate(tree);
         }
         // RR case
-        else if (balance < -1 && strcmp((*tree)->key, key) < 0) {
+        else if (balance < -1 && key_compare((*tree)->key, key) < 0) {
             left_rotate(tree);
         }
         // LR case
-        else if (balance > 1 && strcmp((*tree)->key, key) < 0) {
+        else if (balance > 1 && key_compare((*tree)->key, key) < 0) {
             left_rotate(&((*tree)->left));
             right_rotate(tree);
         }
         // RL case
-        else if (balance < -1 && strcmp((*tree)->key, key) > 0) {
+        else if (balance < -1 && key_compare((*tree)->key, key) > 0) {
             right_rotate(&((*tree)->right));
             left_rotate(tree);
         }
@@ -207,15 +220,15 @@ void symtable_insert(AVL_tree **tree, char *key, sym_data *data) {
 }
 
 
-void symtable_delete(AVL_tree **tree, char *key) {
+void symtable_delete(symtable_t **tree, char *key) {
     if ((*tree) != NULL) {
-        if (strcmp((*tree)->key, key) > 0) {
+        if (key_compare((*tree)->key, key) > 0) {
             symtable_delete(&((*tree)->left), key);
         }
-        else if (strcmp((*tree)->key, key) < 0) {
+        else if (key_compare((*tree)->key, key) < 0) {
             symtable_delete(&((*tree)->right), key);
         }
-        else {  // strcmp((*tree)->key, key) == 0 -> found the node to delete
+        else {  // key_compare((*tree)->key, key) == 0 -> found the node to delete
             if ((*tree)->left == NULL && (*tree)->right == NULL) { // no children
                 free(*tree);
                 *tree = NULL;
@@ -273,7 +286,7 @@ void symtable_delete(AVL_tree **tree, char *key) {
 }
 
 
-void symtable_dispose(AVL_tree **tree) {
+void symtable_dispose(symtable_t **tree) {
     if ((*tree) != NULL) {
         if ((*tree)->left != NULL && (*tree)->right != NULL) {
             symtable_dispose(&((*tree)->left));
@@ -286,10 +299,6 @@ void symtable_dispose(AVL_tree **tree) {
             symtable_dispose(&((*tree)->right));
         }
         else { // (*tree)->left == NULL && (*tree)->right == NULL
-            if ((*tree)->data->param_name) {
-                free((*tree)->data->param_name);
-                (*tree)->data->param_name = NULL;
-            }
             if ((*tree)->data) {
                 free((*tree)->data);
                 (*tree)->data = NULL;
@@ -299,3 +308,150 @@ void symtable_dispose(AVL_tree **tree) {
         }
     }
 }
+
+#else // SYMTABLE_HASH
+
+// Slot of the key, or the empty slot where it belongs, the hash was computed once when the key was interned
+static symtable_slot *symtable_probe(symtable_t *table, const char *key, unsigned int hash) {
+    unsigned int i = hash & (table->capacity - 1);
+    while (table->slots[i].key != NULL && table->slots[i].key != key) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    return &table->slots[i];
+}
+
+// Double the number of slots when the table gets half full
+static void symtable_grow(symtable_t *table) {
+    symtable_slot *old = table->slots;
+    int old_capacity = table->capacity;
+
+    table->capacity *= 2;
+    table->slots = (symtable_slot *)allocate_memory(table->capacity * sizeof(symtable_slot));
+    memset(table->slots, 0, table->capacity * sizeof(symtable_slot));
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].key != NULL) {
+            *symtable_probe(table, old[i].key, old[i].hash) = old[i];
+        }
+    }
+    free(old);
+}
+
+// New symbol from the last block, the next block is twice as big as the previous one
+static AVL_tree *symtable_new_symbol(symtable_t *table) {
+    if (table->block_count == 0 || table->block_used == SYMTABLE_HASH_INIT << (table->block_count - 1)) {
+        if (table->block_count == SYMTABLE_HASH_BLOCKS) {
+            error_exit(ERROR_INTERNAL, "SYMTABLE", "Too many symbols in one symbol table.");
+        }
+        table->blocks[table->block_count] = (AVL_tree *)allocate_memory((SYMTABLE_HASH_INIT << table->block_count) * sizeof(AVL_tree));
+        table->block_count++;
+        table->block_used = 0;
+    }
+    return &table->blocks[table->block_count - 1][table->block_used++];
+}
+
+AVL_tree *symtable_search(symtable_t *tree, char *key) {
+    if (tree == NULL || key == NULL) {
+        return NULL;
+    }
+    symtable_slot *slot = symtable_probe(tree, key, intern_hash(key));
+    return slot->key != NULL ? slot->symbol : NULL;
+}
+
+
+AVL_tree *symtable_find_param(symtable_t *tree, int order_arg) {
+    if (tree == NULL) {
+        return NULL;
+    }
+    for (int b = 0; b < tree->block_count; b++) {
+        int used = b == tree->block_count - 1 ? tree->block_used : SYMTABLE_HASH_INIT << b;
+        for (int i = 0; i < used; i++) {
+            AVL_tree *symbol = &tree->blocks[b][i];
+            // Deleted symbols have no key
+            if (symbol->key != NULL && symbol->data->is_param && symbol->data->param_order == order_arg) {
+                return symbol;
+            }
+        }
+    }
+    return NULL;
+}
+
+
+void symtable_insert(symtable_t **tree, char *key, sym_data *data) {
+    if (*tree == NULL) { // insert first to an empty table
+        *tree = (symtable_t *)allocate_memory(sizeof(symtable_t));
+        (*tree)->capacity = SYMTABLE_HASH_INIT;
+        (*tree)->count = 0;
+        (*tree)->slots = (symtable_slot *)allocate_memory(SYMTABLE_HASH_INIT * sizeof(symtable_slot));
+        memset((*tree)->slots, 0, SYMTABLE_HASH_INIT * sizeof(symtable_slot));
+        (*tree)->block_count = 0;
+        (*tree)->block_used = 0;
+    }
+
+    unsigned int hash = intern_hash(key);
+    symtable_slot *slot = symtable_probe(*tree, key, hash);
+    if (slot->key != NULL) {
+        error_exit(ERROR_SEM_UNDEF_FUN, "SYMTABLE", "Key already exists in the symbol table.");
+    }
+
+    AVL_tree *symbol = symtable_new_symbol(*tree);
+    symbol->key = key;
+    symbol->data = data;
+    symbol->left = NULL;
+    symbol->right = NULL;
+    symbol->height = 0;
+    symbol->nickname = 0;
+    slot->hash = hash;
+    slot->key = key;
+    slot->symbol = symbol;
+
+    if (2 * ++(*tree)->count > (*tree)->capacity) {
+        symtable_grow(*tree);
+    }
+}
+
+
+void symtable_delete(symtable_t **tree, char *key) {
+    if (*tree == NULL) {
+        return;
+    }
+    symtable_slot *slot = symtable_probe(*tree, key, intern_hash(key));
+    if (slot->key == NULL) {
+        return;
+    }
+    // The symbol stays in its block, it is just not found anymore, its data are not freed as in the tree
+    slot->symbol->key = NULL;
+    slot->symbol->data = NULL;
+    slot->key = NULL;
+    (*tree)->count--;
+
+    // Following keys of the cluster are moved back so that probing does not stop at the hole
+    int mask = (*tree)->capacity - 1;
+    int hole = slot - (*tree)->slots;
+    for (int i = (hole + 1) & mask; (*tree)->slots[i].key != NULL; i = (i + 1) & mask) {
+        int home = (*tree)->slots[i].hash & mask;
+        // The key can move to the hole if the hole lies between its home slot and its current slot
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            (*tree)->slots[hole] = (*tree)->slots[i];
+            (*tree)->slots[i].key = NULL;
+            hole = i;
+        }
+    }
+}
+
+
+void symtable_dispose(symtable_t **tree) {
+    if ((*tree) != NULL) {
+        for (int b = 0; b < (*tree)->block_count; b++) {
+            int used = b == (*tree)->block_count - 1 ? (*tree)->block_used : SYMTABLE_HASH_INIT << b;
+            for (int i = 0; i < used; i++) {
+                free((*tree)->blocks[b][i].data);
+            }
+            free((*tree)->blocks[b]);
+        }
+        free((*tree)->slots);
+        free(*tree);
+        *tree = NULL;
+    }
+}
+
+#endif // SYMTABLE_HASH
@@ -3,7 +3,8 @@
  *
  * IFJ23 compiler
  *
- * @brief Symbol table using self-balancing binary search tree (AVL tree)
+ * @brief Symbol table using self-balancing binary search tree (AVL tree), or open addressing hash table
+ *        when compiled with SYMTABLE_HASH defined (make SYMTABLE=hash)
  *
  * @author Adam Valík <xvalik05>
  * @author Marek Effenberger <xeffen00>
@@ -17,6 +18,14 @@
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
+#ifdef SYMTABLE_HASH
+#define SYMTABLE_BACKEND "hash"
+#define SYMTABLE_HASH_INIT 8 // initial number of slots of the hash table, power of two
+#define SYMTABLE_HASH_BLOCKS 26 // symbols are allocated in blocks doubling in size, this many blocks at most
+#else
+#define SYMTABLE_BACKEND "avl"
+#endif
+
 // Data types
 typedef enum e_data_type {
     INT,
@@ -57,9 +66,9 @@ typedef struct symbol_data {
     int param_order;
 } sym_data;
 
-// Struct for the AVL tree
+// Struct for the AVL tree, it is the symbol in the hash table too (without the tree links)
 typedef struct avl_tree {
-    char *key;  // name of the symbol (identifier)
+    char *key;  // interned name of the symbol (identifier)
     sym_data *data;
     struct avl_tree *left;
     struct avl_tree *right;
@@ -67,6 +76,27 @@ typedef struct avl_tree {
     int nickname; // for renaming purposes (codegen)
 } AVL_tree;
 
+#ifdef SYMTABLE_HASH
+// Slot of the hash table, the key and its hash are cached in the slot so that probing does not touch the symbols
+typedef struct symtable_slot {
+    unsigned int hash; // hash of the interned key
+    char *key; // NULL if the slot is empty
+    AVL_tree *symbol;
+} symtable_slot;
+
+// Struct for the hash table with linear probing, keys are interned so they are compared by address
+typedef struct symtable_hash {
+    symtable_slot *slots;
+    int capacity; // number of slots, power of two
+    int count; // number of symbols
+    AVL_tree *blocks[SYMTABLE_HASH_BLOCKS]; // symbols in order of insertion, they never move
+    int block_count;
+    int block_used; // number of used symbols in the last block
+} symtable_t;
+#else
+typedef AVL_tree symtable_t; // the tree is represented by its root
+#endif
+
 
 /**
  * @brief Data initialization
@@ -98,7 +128,7 @@ sym_data *set_data_func(data_type return_type);
  * @brief Set the parameter's data
  * 
  * @param param_type Data type of the parameter
- * @param param_name Name of the parameter
+ * @param param_name Interned name of the parameter
  * @param param_order Order of the parameter
  */
 sym_data *set_data_param(data_type param_type, char *param_name, int param_order);
@@ -107,21 +137,23 @@ sym_data *set_data_param(data_type param_type, char *param_name, int param_order
 /**
  * @brief Symbol search in the symbol table
  * 
- * @param tree Pointer to the root of the tree
- * @param key Key of the node
+ * @param tree Pointer to the symbol table (root of the tree), NULL if empty
+ * @param key Interned key of the node
  * @return AVL_tree* Pointer to the node (symbol)
  */
-AVL_tree *symtable_search(AVL_tree *tree, char *key);
+AVL_tree *symtable_search(symtable_t *tree, char *key);
 
 
 /**
  * @brief Traverse the tree and find the parameter with the given order
  *
- * @param tree Pointer to the root of the tree
+ * @param tree Pointer to the symbol table (root of the tree), NULL if empty
  * @param order_arg Order of the parameter
  * @return AVL_tree* Pointer to the node (symbol)
  */
-AVL_tree *symtable_find_param(AVL_tree *tree, int order_arg);
+AVL_tree *symtable_find_param(symtable_t *tree, int order_arg);
+
+#ifndef SYMTABLE_HASH
 
 
 /**
@@ -156,33 +188,34 @@ void right_rotate(AVL_tree **tree);
  * @param tree Pointer to the root of the tree
  */
 void left_rotate(AVL_tree **tree);
+#endif
 
 
 /**
  * @brief Insertion of the symbol into the symbol table
  * 
- * @param tree Pointer to the root of the tree
- * @param key Key of the node
+ * @param tree Pointer to the symbol table (root of the tree), it is created if NULL
+ * @param key Interned key of the node
  * @param data Data of the node
  */
-void symtable_insert(AVL_tree **tree, char *key, sym_data *data);
+void symtable_insert(symtable_t **tree, char *key, sym_data *data);
 
 
 /**
  * @brief Symbol deletion
  * 
- * @param tree Pointer to the root of the tree
- * @param key Key of the node
+ * @param tree Pointer to the symbol table (root of the tree)
+ * @param key Interned key of the node
  */
-void symtable_delete(AVL_tree **tree, char *key);
+void symtable_delete(symtable_t **tree, char *key);
 
 
 /**
  * @brief Symbol table dispose
  * 
- * @param tree Pointer to the root of the tree
+ * @param tree Pointer to the symbol table (root of the tree), it is set to NULL
  */
-void symtable_dispose(AVL_tree **tree);
+void symtable_dispose(symtable_t **tree);
 
 
 #endif //IFJ_SYMTABLE_H
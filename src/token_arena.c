@@ -0,0 +1,163 @@
+/**
+ * @file token_arena.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Arena of tokens and their lexemes released in bulk
+ *
+ * @author Samuel Hejnicek <xhejni00>
+ * @author Dominik Horut <xhorut01>
+ */
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <string.h>
+
+_Thread_local token_arena_t token_arena = {NULL, NULL, NULL, false}; // arena of all tokens of the front end, every thread has its own
+
+
+// Append a chunk able to hold at least size bytes, spare chunk is reused if possible
+static token_chunk_t *token_arena_new_chunk(size_t size) {
+    token_chunk_t *chunk;
+
+    if (size <= TOKEN_CHUNK_SIZE && token_arena.spare != NULL) {
+        chunk = token_arena.spare;
+        token_arena.spare = chunk->next;
+    }
+    else {
+        size_t chunk_size = size > TOKEN_CHUNK_SIZE ? size : TOKEN_CHUNK_SIZE;
+        chunk = (token_chunk_t*)allocate_memory(sizeof(token_chunk_t) + chunk_size);
+        chunk->size = chunk_size;
+    }
+    chunk->used = 0;
+    chunk->next = NULL;
+
+    if (token_arena.last == NULL) {
+        token_arena.first = chunk;
+    }
+    else {
+        token_arena.last->next = chunk;
+    }
+    token_arena.last = chunk;
+    return chunk;
+}
+
+void *token_arena_alloc(size_t size) {
+    // Every allocation is aligned for pointers and doubles
+    size = (size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+
+    token_chunk_t *chunk = token_arena.last;
+    if (chunk == NULL || chunk->used + size > chunk->size) {
+        chunk = token_arena_new_chunk(size);
+    }
+
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+token_t *token_arena_token(token_type_t type) {
+    token_t *token = (token_t*)token_arena_alloc(sizeof(token_t));
+    memset(token, 0, sizeof(token_t));
+    token->type = type;
+    token->value.keyword = DEFAULT_TOKEN_VAL;
+    return token;
+}
+
+char *token_arena_string(const char *str, int length) {
+    char *copy = (char*)token_arena_alloc(length + 1);
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void token_arena_release(token_t *keep) {
+    if (token_arena.keep_all) {
+        return;
+    }
+
+    // Find the chunk holding the token, everything before it is not needed anymore
+    token_chunk_t *holder = token_arena.first;
+    while (holder != NULL && !((char*)keep >= holder->data && (char*)keep < holder->data + holder->size)) {
+        holder = holder->next;
+    }
+    if (holder == NULL) {
+        return;
+    }
+
+    while (token_arena.first != holder) {
+        token_chunk_t *chunk = token_arena.first;
+        token_arena.first = chunk->next;
+
+        // Oversized chunks of huge lexemes are not worth keeping
+        if (chunk->size == TOKEN_CHUNK_SIZE) {
+            chunk->next = token_arena.spare;
+            token_arena.spare = chunk;
+        }
+        else {
+            free(chunk);
+        }
+    }
+}
+
+void token_arena_dispose() {
+    token_chunk_t *lists[2] = {token_arena.first, token_arena.spare};
+    for (int i = 0; i < 2; i++) {
+        while (lists[i] != NULL) {
+            token_chunk_t *next = lists[i]->next;
+            free(lists[i]);
+            lists[i] = next;
+        }
+    }
+    token_arena.first = token_arena.last = token_arena.spare = NULL;
+    token_arena.keep_all = false;
+}
+
+token_arena_t token_arena_detach() {
+    token_arena_t detached = token_arena;
+    token_arena.first = token_arena.last = token_arena.spare = NULL;
+    token_arena.keep_all = false;
+    return detached;
+}
+
+void token_arena_adopt(token_arena_t *other) {
+    if (other->first != NULL) {
+        if (token_arena.last == NULL) {
+            token_arena.first = other->first;
+        }
+        else {
+            token_arena.last->next = other->first;
+        }
+        token_arena.last = other->last;
+    }
+
+    while (other->spare != NULL) {
+        token_chunk_t *next = other->spare->next;
+        free(other->spare);
+        other->spare = next;
+    }
+    other->first = other->last = NULL;
+
+    // Lexemes of the adopted chunks belong to tokens living outside of the arena
+    token_arena.keep_all = true;
+}
+
+void token_arena_release_adopted() {
+    token_arena.keep_all = false;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file token_arena.h
+ *
+ * IFJ23 compiler
+ *
+ * @brief Arena of tokens and their lexemes released in bulk
+ *
+ * @author Samuel Hejnicek <xhejni00>
+ * @author Dominik Horut <xhorut01>
+ */
+
+#ifndef IFJ_TOKEN_ARENA_H
+#define IFJ_TOKEN_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "scanner.h"
+
+#define TOKEN_CHUNK_SIZE 65536 // size of one chunk of the arena
+
+// Chunk of memory tokens and lexemes are bump allocated from
+typedef struct token_chunk {
+    struct token_chunk *next; // newer chunk
+    size_t used;
+    size_t size;
+    char data[];
+} token_chunk_t;
+
+// Arena of tokens, chunks are ordered from the oldest to the newest
+typedef struct token_arena {
+    token_chunk_t *first;
+    token_chunk_t *last;
+    token_chunk_t *spare; // released chunks of default size kept for reuse
+    bool keep_all; // nothing is released while the adopted chunks hold lexemes of tokens living outside of the arena
+} token_arena_t;
+
+
+/**
+ * @brief Allocate memory from the arena
+ *
+ * @param size Size of the memory
+ * @return void* Pointer to the memory, valid until the chunk holding it is released
+ */
+void *token_arena_alloc(size_t size);
+
+
+/**
+ * @brief Allocate a new token from the arena
+ *
+ * @param type Type of the token
+ * @return token_t* Pointer to the token with default values
+ */
+token_t *token_arena_token(token_type_t type);
+
+
+/**
+ * @brief Copy the materialised lexeme into the arena
+ *
+ * @param str Lexeme, it does not have to be null terminated
+ * @param length Length of the lexeme
+ * @return char* Null terminated copy of the lexeme living in the arena
+ */
+char *token_arena_string(const char *str, int length);
+
+
+/**
+ * @brief Release all chunks older than the chunk holding the given token
+ *
+ * @note Called on statement and function boundaries, no token older than keep can be referenced anymore
+ * @param keep Oldest token which is still in use
+ */
+void token_arena_release(token_t *keep);
+
+
+/**
+ * @brief Release the whole arena
+ */
+void token_arena_dispose();
+
+
+/**
+ * @brief Take the arena away from the calling thread, the thread starts with an empty arena
+ *
+ * @return token_arena_t Chunks of the arena, they are handed over to another thread by token_arena_adopt
+ */
+token_arena_t token_arena_detach();
+
+
+/**
+ * @brief Append the chunks of arena detached from another thread to the arena of the calling thread
+ *
+ * @note Chunks are not released until token_arena_release_adopted is called
+ * @param other Detached arena, it is empty afterwards
+ */
+void token_arena_adopt(token_arena_t *other);
+
+
+/**
+ * @brief Allow releasing of the adopted chunks again
+ *
+ * @note Called when the last token referencing them is handed out, tokens allocated afterwards are newer than all of them
+ */
+void token_arena_release_adopted();
+
+
+#endif //IFJ_TOKEN_ARENA_H
@@ -0,0 +1,187 @@
+/**
+ * @file token_pipe.c
+ *
+ * IFJ23 compiler
+ *
+ * @brief Scanning on own thread which feeds the parser through single producer single consumer ring
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "callee.h"
+#include "cnt_stack.h"
+#include "codegen.h"
+#include "emit.h"
+#include "error.h"
+#include "expression_parser.h"
+#include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "queue.h"
+#include "scanner.h"
+#include "simd.h"
+#include "string_vector.h"
+#include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
+#include "token_stack.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64 // counters of the threads are kept apart to avoid false sharing
+
+bool token_pipe_enabled = false;
+
+static struct token_pipe {
+    _Alignas(CACHE_LINE) _Atomic size_t head; // number of pushed tokens, written by the scanner thread
+    _Alignas(CACHE_LINE) _Atomic size_t tail; // number of popped tokens, written by the parser thread
+    _Alignas(CACHE_LINE) _Atomic bool closed; // the scanner thread pushed its last token
+    _Atomic bool cancelled; // the parser thread does not take any more tokens
+    const char *resume; // position the parser thread continues scanning at, valid once closed
+    const source_t *code; // source code loaded by the parser thread
+    const char *start; // position the scanner thread starts at
+    bool running; // owned by the parser thread
+    pthread_t thread;
+    token_t slots[TOKEN_PIPE_CAPACITY];
+} token_pipe;
+
+// Strings of the tokens scanned by the scanner thread live in its own token arena
+static bool is_arena_string(const char *lexeme) {
+    return lexeme != NULL && (lexeme < token_pipe.code->data || lexeme > token_pipe.code->end);
+}
+
+// Release the chunks of the scanner arena holding only strings the parser thread has copied already
+static void token_pipe_reclaim(const char *newest) {
+    size_t head = atomic_load_explicit(&token_pipe.head, memory_order_relaxed);
+    const char *keep = newest;
+
+    for (size_t i = atomic_load_explicit(&token_pipe.tail, memory_order_acquire); i < head; i++) {
+        const char *lexeme = token_pipe.slots[i & (TOKEN_PIPE_CAPACITY - 1)].value.lexeme;
+        if (is_arena_string(lexeme)) {
+            keep = lexeme;
+            break;
+        }
+    }
+    if (keep != NULL) {
+        // Any address inside of the chunk locates it
+        token_arena_release((token_t*)keep);
+    }
+}
+
+static void *token_pipe_scan(void *arg) {
+    (void)arg;
+    const source_t *code = token_pipe.code;
+    token_stream_t batch = {0};
+    const char *position = token_pipe.start;
+    const char *newest = NULL; // newest string pushed from the token arena of this thread
+    bool last = false;
+
+    while (!last && !atomic_load_explicit(&token_pipe.cancelled, memory_order_relaxed)) {
+        const char *limit = code->end - position > TOKEN_PIPE_BATCH ? position + TOKEN_PIPE_BATCH : code->end;
+        batch.count = 0;
+        scan_range(&batch, code, position, limit);
+
+        for (size_t i = 0; i < batch.count; i++) {
+            size_t head = atomic_load_explicit(&token_pipe.head, memory_order_relaxed);
+            while (head - atomic_load_explicit(&token_pipe.tail, memory_order_acquire) == TOKEN_PIPE_CAPACITY) {
+                if (atomic_load_explicit(&token_pipe.cancelled, memory_order_relaxed)) {
+                    break;
+                }
+                sched_yield();
+            }
+            if (atomic_load_explicit(&token_pipe.cancelled, memory_order_relaxed)) {
+                break;
+            }
+            token_pipe.slots[head & (TOKEN_PIPE_CAPACITY - 1)] = batch.tokens[i];
+            atomic_store_explicit(&token_pipe.head, head + 1, memory_order_release);
+
+            if (is_arena_string(batch.tokens[i].value.lexeme)) {
+                newest = batch.tokens[i].value.lexeme;
+            }
+            if ((head + 1) % TOKEN_PIPE_CAPACITY == 0) {
+                token_pipe_reclaim(newest);
+            }
+        }
+
+        position = batch.exit;
+        last = batch.failed || (batch.count > 0 && batch.tokens[batch.count - 1].type == TOKEN_EOF);
+    }
+
+    token_pipe.resume = position;
+    atomic_store_explicit(&token_pipe.closed, true, memory_order_release);
+
+    // Strings of the pushed tokens are needed until the parser thread takes them all
+    while (atomic_load_explicit(&token_pipe.tail, memory_order_acquire) != atomic_load_explicit(&token_pipe.head, memory_order_relaxed) &&
+           !atomic_load_explicit(&token_pipe.cancelled, memory_order_acquire)) {
+        sched_yield();
+    }
+    free(batch.tokens);
+    free(batch.starts);
+    scanner_thread_dispose();
+    token_arena_dispose();
+    return NULL;
+}
+
+void token_pipe_start() {
+    if (!token_pipe_enabled) {
+        return;
+    }
+
+    token_pipe.code = &source;
+    token_pipe.start = source.cursor;
+    atomic_init(&token_pipe.head, 0);
+    atomic_init(&token_pipe.tail, 0);
+    atomic_init(&token_pipe.closed, false);
+    atomic_init(&token_pipe.cancelled, false);
+    if (pthread_create(&token_pipe.thread, NULL, token_pipe_scan, NULL) != 0) {
+        error_exit(ERROR_INTERNAL, "SCANNER", "Scanner thread cannot be created");
+    }
+    token_pipe.running = true;
+}
+
+token_t *token_pipe_pop() {
+    if (!token_pipe.running) {
+        return NULL;
+    }
+
+    size_t tail = atomic_load_explicit(&token_pipe.tail, memory_order_relaxed);
+    while (atomic_load_explicit(&token_pipe.head, memory_order_acquire) == tail) {
+        if (atomic_load_explicit(&token_pipe.closed, memory_order_acquire) &&
+            atomic_load_explicit(&token_pipe.head, memory_order_acquire) == tail) {
+            // The scanner thread stopped, lexical error is found again by scanning on this thread
+            pthread_join(token_pipe.thread, NULL);
+            token_pipe.running = false;
+            source.cursor = token_pipe.resume;
+            return NULL;
+        }
+        sched_yield();
+    }
+
+    token_t *token = token_arena_token(TOKEN_EOF);
+    *token = token_pipe.slots[tail & (TOKEN_PIPE_CAPACITY - 1)];
+    // Intern pool and token arena of this thread are used by this thread only
+    if (token->type == TOKEN_ID || token->type == TOKEN_KEYWORD || token->type == TOKEN_KEYWORD_QM || token->type == TOKEN_UNDERSCORE) {
+        token->value.name = intern(token->value.lexeme, token->value.length);
+    }
+    else if (is_arena_string(token->value.lexeme)) {
+        token->value.lexeme = token_arena_string(token->value.lexeme, token->value.length);
+    }
+    atomic_store_explicit(&token_pipe.tail, tail + 1, memory_order_release);
+    return token;
+}
+
+void token_pipe_stop() {
+    if (!token_pipe.running) {
+        return;
+    }
+    atomic_store_explicit(&token_pipe.cancelled, true, memory_order_release);
+    pthread_join(token_pipe.thread, NULL);
+    token_pipe.running = false;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file token_pipe.h
+ *
+ * IFJ23 compiler
+ *
+ * @brief Scanning on own thread which feeds the parser through single producer single consumer ring
+ *
+ * @author Dominik Horut <xhorut01>
+ * @author Samuel Hejnicek <xhejni00>
+ */
+
+#ifndef IFJ_TOKEN_PIPE_H
+#define IFJ_TOKEN_PIPE_H
+
+#include <stdbool.h>
+#include "scanner.h"
+
+#define TOKEN_PIPE_CAPACITY 1024 // number of tokens in flight between the threads, power of two
+#define TOKEN_PIPE_BATCH 4096 // bytes of the source code the scanner thread scans at once
+
+extern bool token_pipe_enabled; // scanning runs on own thread ahead of the parser
+
+/**
+ * @brief Start the scanner thread at the current position of the source code if the pipe is enabled
+ */
+void token_pipe_start();
+
+/**
+ * @brief Take the next token scanned by the scanner thread, called by get_me_token
+ *
+ * @note Names are interned and strings are copied into the token arena of the calling thread. When the scanner
+ *       thread stops at the end or at lexical error, the source code continues to be scanned by the calling thread.
+ * @return token_t* Token allocated from the token arena, NULL if the pipe does not run
+ */
+token_t *token_pipe_pop();
+
+/**
+ * @brief Stop the scanner thread if it still runs, the tokens it has not handed over are dropped
+ */
+void token_pipe_stop();
+
+#endif //IFJ_TOKEN_PIPE_H
@@ -11,14 +11,20 @@
 #include "callee.h"
 #include "cnt_stack.h"
 #include "codegen.h"
+#include "emit.h"
 #include "error.h"
 #include "expression_parser.h"
 #include "forest.h"
+#include "intern.h"
+#include "parallel_lexer.h"
 #include "parser.h"
 #include "queue.h"
 #include "scanner.h"
+#include "simd.h"
 #include "string_vector.h"
 #include "symtable.h"
+#include "token_arena.h"
+#include "token_pipe.h"
 #include "token_stack.h"
 
 //default stack size
@@ -71,11 +77,7 @@ token_t* stack_top_terminal(token_stack* token_stack){
 }
 
 void dispose_stack(token_stack* token_stack) {
-
-    for(int i = 0; i < token_stack->size; i++){
-        destroy_token(token_stack->token_array[i]);
-    }
-
+    //Tokens are owned by the token arena, only the array is released
     free(token_stack->token_array);
     token_stack->token_array = NULL;
     
@@ -0,0 +1,3 @@
+// int of IFJcode23 has 64 bits, literals above 2^31 - 1 are valid
+let big = 2147483648
+write(big, "\n")
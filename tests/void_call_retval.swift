@@ -0,0 +1,8 @@
+// Calls of one function with and without assignment mixed, only the assigning call pushes the return value
+func inc(_ x : Int) -> Int {
+    return x + 1
+}
+inc(1)
+let a = inc(2)
+inc(3)
+write(a, "\n")